@@ -1,11 +1,15 @@
 #pragma once
 
 #define SPLIT_LAYER_STATE_ENABLE
-#define RGB_MATRIX_DEFAULT_MODE RGB_MATRIX_BREATHING
+#define SPLIT_TRANSACTION_IDS_USER RPC_ID_USER_IDLE_GOVERNOR
+#define RGB_MATRIX_DEFAULT_MODE RGB_MATRIX_CUSTOM_BREATHING_TABLE
 #define PERMISSIVE_HOLD
 
 #define ACHORDION_STREAK
+#define ACHORDION_STREAK_TAP_ON_PRESS
+#define ACHORDION_OVERLAP_HOLD
 
 #define TAPPING_TERM 200
+#define TAPPING_TERM_PER_KEY
 
 #define BOTH_SHIFTS_TURNS_ON_CAPS_WORD
@@ -21,6 +21,32 @@
  */
 
 #include "achordion.h"
+#include "scan_profiler.h"
+#include "token_log.h"
+
+#ifdef KEY_RECORDER_ENABLE
+#include "key_recorder.h"
+#define record_settle_kind(tracked, kind) \
+  key_recorder_settle((tracked)->record.event.key, (kind))
+#else
+#define record_settle_kind(tracked, kind) (void)(tracked)
+#endif  // KEY_RECORDER_ENABLE
+
+#ifdef TAP_HOLD_STATS_ENABLE
+#include "tap_hold_stats.h"
+#define record_settle_outcome(tracked, outcome) \
+  tap_hold_stats_settle(&(tracked)->record, (outcome))
+#else
+#define record_settle_outcome(tracked, outcome) (void)(tracked)
+#endif  // TAP_HOLD_STATS_ENABLE
+
+// Logs a settle decision for a tracked tap-hold key, as a Key Recorder kind
+// and a Tap-Hold Stats outcome.
+#define record_settle(tracked, kind, outcome) \
+  do {                                        \
+    record_settle_kind(tracked, kind);        \
+    record_settle_outcome(tracked, outcome);  \
+  } while (0)
 
 #if !defined(IS_QK_MOD_TAP)
 // Attempt to detect out-of-date QMK installation, which would fail with
@@ -28,266 +54,712 @@
 #error "achordion: QMK version is too old to build. Please update QMK."
 #else
 
-// Copy of the `record` and `keycode` args for the current active tap-hold key.
-static keyrecord_t tap_hold_record;
-static uint16_t tap_hold_keycode = KC_NO;
-// Timeout timer. When it expires, the key is considered held.
-static uint16_t hold_timer = 0;
-// Eagerly applied mods, if any.
-static uint8_t eager_mods = 0;
-// Flag to determine whether another key is pressed within the timeout.
-static bool pressed_another_key_before_release = false;
+#ifndef ACHORDION_MAX_KEYS
+#define ACHORDION_MAX_KEYS 4
+#endif  // ACHORDION_MAX_KEYS
 
-#ifdef ACHORDION_STREAK
-// Timer for typing streak
-static uint16_t streak_timer = 0;
-#else
-// When disabled, is_streak is never true
-#define is_streak false
-#endif
-
-// Achordion's current state.
+// State of a tap-hold key that Achordion tracks.
 enum {
-  // A tap-hold key is pressed, but hasn't yet been settled as tapped or held.
+  // The key is pressed, but hasn't yet been settled as tapped or held.
   STATE_UNSETTLED,
-  // Achordion is inactive.
-  STATE_RELEASED,
-  // Active tap-hold key has been settled as tapped.
+  // The key has been settled as tapped.
   STATE_TAPPING,
-  // Active tap-hold key has been settled as held.
+  // The key has been settled as held.
   STATE_HOLDING,
-  // This state is set while calling `process_record()`, which will recursively
-  // call `process_achordion()`. This state is checked so that we don't process
-  // events generated by Achordion and potentially create an infinite loop.
-  STATE_RECURSING,
 };
-static uint8_t achordion_state = STATE_RELEASED;
+
+// A tap-hold key that Achordion tracks from its press to its release.
+typedef struct {
+  // Copy of the `record` and `keycode` args of the press.
+  keyrecord_t record;
+  uint16_t keycode;
+  // Timeout timer. When it expires, the key is considered held.
+  uint16_t hold_timer;
+  // Eagerly applied mods, if any.
+  uint8_t eager_mods;
+  uint8_t state;
+  // The tap was sent ahead of the decision and is taken back if the key
+  // settles as held.
+  bool speculated;
+} tap_hold_key_t;
+
+// Tracked tap-hold keys, in the order they were pressed. Several of them can
+// be unsettled at once, so that mods chorded together each wait for their own
+// next key instead of the first settling the others.
+static tap_hold_key_t tap_hold_keys[ACHORDION_MAX_KEYS];
+static uint8_t tap_hold_count = 0;
+// Set while calling `process_record()`, which will recursively call
+// `process_achordion()`. This is checked so that we don't process events
+// generated by Achordion and potentially create an infinite loop.
+static bool recursing = false;
+// Tap-hold keys down that QMK's tap-hold handling has seen, as tracked by
+// `pre_process_achordion()`. A buffered press can resolve to another keycode
+// by the time QMK handles it, so releases are matched by position.
+static bool tap_hold_pressed[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t tap_hold_down = 0;
+
+#ifdef ACHORDION_SPECULATIVE_TAP
+// The key whose tap was sent at its press, until QMK taps it or hands it over
+// as held.
+static keypos_t speculated_key;
+static bool speculating = false;
+#endif  // ACHORDION_SPECULATIVE_TAP
+
+static bool same_key(keypos_t a, keypos_t b) {
+  return a.row == b.row && a.col == b.col;
+}
+
+#ifdef DEFERRED_EXEC_ENABLE
+// Callback that settles unsettled keys as held when their hold_timer expires.
+static deferred_token hold_token = INVALID_DEFERRED_TOKEN;
+#endif  // DEFERRED_EXEC_ENABLE
 
 #ifdef ACHORDION_STREAK
+#define MAX_STREAK_TIMEOUT 800
+// Timer for typing streak
+static uint16_t streak_timer = 0;
+#ifdef DEFERRED_EXEC_ENABLE
+// Callback that expires streak_timer.
+static deferred_token streak_token = INVALID_DEFERRED_TOKEN;
+#endif  // DEFERRED_EXEC_ENABLE
+
+#ifdef DEFERRED_EXEC_ENABLE
+static uint32_t streak_timeout_callback(uint32_t trigger_time, void* cb_arg) {
+  SCAN_PROFILE_SCOPE(SCAN_PROFILE_ACHORDION_TIMERS);
+  streak_timer = 0;  // Expired.
+  streak_token = INVALID_DEFERRED_TOKEN;
+  return 0;
+}
+#endif  // DEFERRED_EXEC_ENABLE
+
 static void update_streak_timer(uint16_t keycode, keyrecord_t* record) {
   if (achordion_streak_continue(keycode)) {
     // We use 0 to represent an unset timer, so `| 1` to force a nonzero value.
     streak_timer = record->event.time | 1;
+#ifdef DEFERRED_EXEC_ENABLE
+    if (!extend_deferred_exec(streak_token, MAX_STREAK_TIMEOUT)) {
+      streak_token =
+          defer_exec(MAX_STREAK_TIMEOUT, streak_timeout_callback, NULL);
+    }
+#endif  // DEFERRED_EXEC_ENABLE
   } else {
     streak_timer = 0;
   }
 }
 #endif
 
-// Presses or releases eager_mods through process_action(), which skips the
-// usual event handling pipeline. The action is considered as a mod-tap hold or
-// release, with Retro Tapping if enabled.
-static void process_eager_mods_action(void) {
+// Returns true if `key` is pressed within a typing streak, judged at the press
+// of the next key.
+static bool is_streak(const tap_hold_key_t* key, uint16_t next_keycode,
+                      const keyrecord_t* next_record) {
+#ifdef ACHORDION_STREAK
+  const uint16_t s_timeout =
+      achordion_streak_chord_timeout(key->keycode, next_keycode);
+  return streak_timer && s_timeout &&
+         !timer_expired(next_record->event.time, (streak_timer + s_timeout));
+#else
+  return false;  // When disabled, is_streak is never true.
+#endif
+}
+
+#ifdef ACHORDION_STREAK_TAP_ON_PRESS
+// Returns true if `keycode` is pressed within a typing streak, judged at its
+// own press, so it can be tapped without waiting for the next key.
+static bool is_streak_press(uint16_t keycode, const keyrecord_t* record) {
+  const uint16_t s_timeout = achordion_streak_chord_timeout(keycode, KC_NO);
+  return streak_timer && s_timeout && achordion_streak_continue(keycode) &&
+         !timer_expired(record->event.time, (streak_timer + s_timeout));
+}
+#endif  // ACHORDION_STREAK_TAP_ON_PRESS
+
+// Returns the index of the tracked key with `keycode`, or tap_hold_count.
+static uint8_t find_key(uint16_t keycode) {
+  uint8_t i = 0;
+  while (i < tap_hold_count && tap_hold_keys[i].keycode != keycode) {
+    ++i;
+  }
+  return i;
+}
+
+// Returns true if a tracked key pressed before `index` is unsettled.
+static bool unsettled_before(uint8_t index) {
+  for (uint8_t i = 0; i < index; ++i) {
+    if (tap_hold_keys[i].state == STATE_UNSETTLED) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Presses or releases the eager mods of `key` through process_action(), which
+// skips the usual event handling pipeline. The action is considered as a
+// mod-tap hold or release, with Retro Tapping if enabled.
+static void process_eager_mods_action(tap_hold_key_t* key) {
   action_t action;
   action.code = ACTION_MODS_TAP_KEY(
-      eager_mods, QK_MOD_TAP_GET_TAP_KEYCODE(tap_hold_keycode));
-  process_action(&tap_hold_record, action);
+      key->eager_mods, QK_MOD_TAP_GET_TAP_KEYCODE(key->keycode));
+  process_action(&key->record, action);
 }
 
-// Calls `process_record()` with state set to RECURSING.
-static void recursively_process_record(keyrecord_t* record, uint8_t state) {
-  achordion_state = STATE_RECURSING;
+#ifndef ACHORDION_REPLAY_SIZE
+#define ACHORDION_REPLAY_SIZE 4
+#endif  // ACHORDION_REPLAY_SIZE
+
+// Events that a settle decision plumbs back into the handling pipeline: the
+// tap or hold events and the event that triggered the decision. They are
+// queued as the decision is made and replayed together by `replay_events()`.
+static struct {
+  keyrecord_t record;
+  bool send_report;  // Send the keyboard report after processing it.
+} replay_queue[ACHORDION_REPLAY_SIZE];
+static uint8_t replay_count = 0;
+
+static void replay_events(void);
+
+// Queues `record` to be plumbed.
+static void queue_replay(const keyrecord_t* record, bool send_report) {
+  if (replay_count == ACHORDION_REPLAY_SIZE) {
+    replay_events();
+  }
+  replay_queue[replay_count].record = *record;
+  replay_queue[replay_count].send_report = send_report;
+  ++replay_count;
+}
+
+// Calls `process_record()` on the queued events in one pass, with recursing
+// set.
+static void replay_events(void) {
+  if (!replay_count) {
+    return;
+  }
+  recursing = true;
 #if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE)
   int8_t mouse_key_tracker = get_auto_mouse_key_tracker();
 #endif
-  process_record(record);
+  for (uint8_t i = 0; i < replay_count; ++i) {
+    process_record(&replay_queue[i].record);
+    if (replay_queue[i].send_report) {
+      send_keyboard_report();
+    }
+  }
+  replay_count = 0;
 #if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE)
   set_auto_mouse_key_tracker(mouse_key_tracker);
 #endif
-  achordion_state = state;
+  recursing = false;
 }
 
-// Sends hold press event and settles the active tap-hold key as held.
-static void settle_as_hold(void) {
-  if (eager_mods) {
+static void take_back_tap(tap_hold_key_t* key);
+
+// Queues hold press event and settles `key` as held.
+static void settle_as_hold(tap_hold_key_t* key) {
+  if (key->eager_mods) {
     // If eager mods are being applied, nothing needs to be done besides
     // updating the state.
-    dprintln("Achordion: Settled eager mod as hold.");
-    achordion_state = STATE_HOLDING;
+    token_log(ACHORDION_LOG_EAGER_HOLD, 0);
   } else {
+    take_back_tap(key);
     // Create hold press event.
-    dprintln("Achordion: Plumbing hold press.");
-    recursively_process_record(&tap_hold_record, STATE_HOLDING);
+    token_log(ACHORDION_LOG_HOLD_PRESS, 0);
+    queue_replay(&key->record, false);
+  }
+  key->state = STATE_HOLDING;
+}
+
+#if TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+#ifndef ACHORDION_PENDING_RELEASES
+#define ACHORDION_PENDING_RELEASES 4
+#endif  // ACHORDION_PENDING_RELEASES
+
+// Tap releases waiting out TAP_CODE_DELAY, oldest first. Instead of blocking
+// in `wait_ms()` between a tap's press and release, the release is plumbed by
+// a deferred callback, and the event that settled the tap is processed
+// meanwhile. Its press still reaches the host after the tap press.
+static struct {
+  keyrecord_t record;
+  uint16_t keycode;  // The tap keycode.
+  uint16_t time;     // When to release.
+} pending_releases[ACHORDION_PENDING_RELEASES];
+static uint8_t pending_release_count = 0;
+static deferred_token release_token = INVALID_DEFERRED_TOKEN;
+
+// Returns the keycode that `keycode` sends when tapped.
+static uint16_t get_tap_keycode(uint16_t keycode) {
+  if (IS_QK_MOD_TAP(keycode)) {
+    return QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+  } else if (IS_QK_LAYER_TAP(keycode)) {
+    return QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+  }
+  return keycode;
+}
+
+// Plumbs the oldest pending tap release.
+static void release_oldest_tap(void) {
+  keyrecord_t record = pending_releases[0].record;
+  --pending_release_count;
+  for (uint8_t i = 0; i < pending_release_count; ++i) {
+    pending_releases[i] = pending_releases[i + 1];
   }
+  token_log(ACHORDION_LOG_TAP_RELEASE, 0);
+  queue_replay(&record, false);
+  replay_events();
 }
 
-// Sends tap press and release and settles the active tap-hold key as tapped.
-static void settle_as_tap(void) {
-  if (eager_mods) {  // Clear eager mods if set.
+// Before `keycode` is pressed, plumbs the pending releases up to its last tap,
+// so that the host sees it go up and down again. Before a key is released,
+// plumbs them up to the tap of the same key, while the layer it was pressed on
+// is still cached for the tap release to resolve against.
+static void release_pending_taps_of(uint16_t keycode,
+                                    const keyrecord_t* record) {
+  keycode = get_tap_keycode(keycode);
+  for (uint8_t i = pending_release_count; i > 0; --i) {
+    const keypos_t pos = pending_releases[i - 1].record.event.key;
+    if (record->event.pressed ? pending_releases[i - 1].keycode == keycode
+                              : (pos.row == record->event.key.row &&
+                                 pos.col == record->event.key.col)) {
+      while (i-- > 0) {
+        release_oldest_tap();
+      }
+      return;
+    }
+  }
+}
+
+static uint32_t release_callback(uint32_t trigger_time, void* cb_arg) {
+  SCAN_PROFILE_SCOPE(SCAN_PROFILE_ACHORDION_TIMERS);
+  while (pending_release_count &&
+         timer_expired(timer_read(), pending_releases[0].time)) {
+    release_oldest_tap();
+  }
+  if (pending_release_count) {
+    // Measured from trigger_time, which QMK adds the delay to.
+    const int16_t delay =
+        (int16_t)(pending_releases[0].time - (uint16_t)trigger_time);
+    return delay > 0 ? delay : 1;
+  }
+  release_token = INVALID_DEFERRED_TOKEN;
+  return 0;
+}
+
+// Queues the release of the tap `record` of `keycode` for TAP_CODE_DELAY ms.
+static void defer_tap_release(const keyrecord_t* record, uint16_t keycode) {
+  if (pending_release_count == ACHORDION_PENDING_RELEASES) {
+    release_oldest_tap();
+  }
+  pending_releases[pending_release_count].record = *record;
+  pending_releases[pending_release_count].record.event.pressed = false;
+  pending_releases[pending_release_count].keycode = get_tap_keycode(keycode);
+  pending_releases[pending_release_count].time = timer_read() + TAP_CODE_DELAY;
+  ++pending_release_count;
+  // An earlier release already has the callback scheduled, before this one.
+  if (release_token == INVALID_DEFERRED_TOKEN) {
+    release_token = defer_exec(TAP_CODE_DELAY, release_callback, NULL);
+    if (release_token == INVALID_DEFERRED_TOKEN) {  // No free executor.
+      while (pending_release_count) {
+        release_oldest_tap();
+      }
+    }
+  }
+}
+#endif  // TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+
+// Queues tap press and release of `key`. The tap is revised from a copy of
+// the press, which is kept for a hold press.
+static void plumb_tap(const tap_hold_key_t* key) {
+  keyrecord_t record = key->record;
+  token_log(ACHORDION_LOG_TAP_PRESS, 0);
+  record.event.pressed = true;
+  record.tap.count = 1;  // Revise event as a tap.
+  record.tap.interrupted = true;
+  // Plumb tap press event.
+  queue_replay(&record, true);
+
+#if TAP_CODE_DELAY > 0
+#ifdef DEFERRED_EXEC_ENABLE
+  defer_tap_release(&record, key->keycode);
+  return;
+#else
+  replay_events();
+  wait_ms(TAP_CODE_DELAY);
+#endif  // DEFERRED_EXEC_ENABLE
+#endif  // TAP_CODE_DELAY > 0
+
+  token_log(ACHORDION_LOG_TAP_RELEASE, 0);
+  record.event.pressed = false;
+  // Plumb tap release event.
+  queue_replay(&record, false);
+}
+
+// Takes back the tap that was sent ahead for `key`, if any, by tapping
+// Backspace after the events queued so far.
+static void take_back_tap(tap_hold_key_t* key) {
+  if (!key->speculated) {
+    return;
+  }
+  token_log(ACHORDION_LOG_TAKE_BACK_TAP, 0);
+  replay_events();
+#if TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+  while (pending_release_count) {  // The tap goes up before it is erased.
+    release_oldest_tap();
+  }
+#endif  // TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+  tap_code(KC_BSPC);
+  key->speculated = false;
+}
+
+// Queues tap press and release and settles `key` as tapped.
+static void settle_as_tap(tap_hold_key_t* key) {
+  if (key->eager_mods) {  // Clear eager mods if set.
 #if defined(RETRO_TAPPING) || defined(RETRO_TAPPING_PER_KEY)
 #ifdef DUMMY_MOD_NEUTRALIZER_KEYCODE
     neutralize_flashing_modifiers(get_mods());
 #endif  // DUMMY_MOD_NEUTRALIZER_KEYCODE
 #endif  // defined(RETRO_TAPPING) || defined(RETRO_TAPPING_PER_KEY)
-    tap_hold_record.event.pressed = false;
+    replay_events();  // The release goes after the events queued so far.
+    key->record.event.pressed = false;
     // To avoid falsely triggering Retro Tapping, process eager mods release as
     // a regular mods release rather than a mod-tap release.
     action_t action;
-    action.code = ACTION_MODS(eager_mods);
-    process_action(&tap_hold_record, action);
-    eager_mods = 0;
+    action.code = ACTION_MODS(key->eager_mods);
+    process_action(&key->record, action);
+    key->eager_mods = 0;
   }
 
-  dprintln("Achordion: Plumbing tap press.");
-  tap_hold_record.event.pressed = true;
-  tap_hold_record.tap.count = 1;  // Revise event as a tap.
-  tap_hold_record.tap.interrupted = true;
-  // Plumb tap press event.
-  recursively_process_record(&tap_hold_record, STATE_TAPPING);
-
-  send_keyboard_report();
-#if TAP_CODE_DELAY > 0
-  wait_ms(TAP_CODE_DELAY);
-#endif  // TAP_CODE_DELAY > 0
-
-  dprintln("Achordion: Plumbing tap release.");
-  tap_hold_record.event.pressed = false;
-  // Plumb tap release event.
-  recursively_process_record(&tap_hold_record, STATE_TAPPING);
+  key->state = STATE_TAPPING;
+  if (key->speculated) {
+    key->speculated = false;  // The tap was already sent.
+  } else {
+    plumb_tap(key);
+  }
 }
 
-bool process_achordion(uint16_t keycode, keyrecord_t* record) {
-  // Don't process events that Achordion generated.
-  if (achordion_state == STATE_RECURSING) {
+// Settles `key` by the key pressed after it: as tapped within a typing streak,
+// otherwise as held if `hold` or `achordion_chord()` says so. Returns true if
+// it settled as held.
+static bool settle_by_next_key(tap_hold_key_t* key, uint16_t next_keycode,
+                               keyrecord_t* next_record, bool hold) {
+  if (is_streak(key, next_keycode, next_record)) {
+    record_settle(key, KEY_RECORD_SETTLE_STREAK, TAP_HOLD_STREAK_TAP);
+    settle_as_tap(key);
+    return false;
+  }
+  if (hold || achordion_chord(key->keycode, &key->record, next_keycode,
+                              next_record)) {
+    record_settle(key, KEY_RECORD_SETTLE_HOLD, TAP_HOLD_CHORD_HOLD);
+    settle_as_hold(key);
     return true;
   }
+  record_settle(key, KEY_RECORD_SETTLE_TAP, TAP_HOLD_TAP);
+  settle_as_tap(key);
+  return false;
+}
 
-  // Determine whether the current event is for a mod-tap or layer-tap key.
-  const bool is_mt = IS_QK_MOD_TAP(keycode);
-  const bool is_tap_hold = is_mt || IS_QK_LAYER_TAP(keycode);
-  // Check that this is a normal key event, don't act on combos.
-  const bool is_key_event = IS_KEYEVENT(record->event);
+// Settles the unsettled keys whose hold_timer expired as held, along with the
+// unsettled keys pressed before them, which have been held even longer.
+static void settle_expired_holds(void) {
+  // Taking back a tap waits out TAP_CODE_DELAY, over which more timers can
+  // expire, so check again until none did.
+  bool settled;
+  do {
+    uint8_t expired = 0;  // One past the last expired key.
+    for (uint8_t i = 0; i < tap_hold_count; ++i) {
+      if (tap_hold_keys[i].state == STATE_UNSETTLED &&
+          timer_expired(timer_read(), tap_hold_keys[i].hold_timer)) {
+        expired = i + 1;
+      }
+    }
+    settled = false;
+    for (uint8_t i = 0; i < expired; ++i) {
+      if (tap_hold_keys[i].state == STATE_UNSETTLED) {
+        record_settle(&tap_hold_keys[i], KEY_RECORD_SETTLE_TIMEOUT,
+                      TAP_HOLD_TIMEOUT_HOLD);
+        settle_as_hold(&tap_hold_keys[i]);  // Timeout expired, settle as held.
+        settled = true;
+      }
+    }
+  } while (settled);
+  replay_events();
+}
 
-  // Event while no tap-hold key is active.
-  if (achordion_state == STATE_RELEASED) {
-    if (is_tap_hold && record->tap.count == 0 && record->event.pressed &&
-        is_key_event) {
-      // A tap-hold key is pressed and considered by QMK as "held".
-      const uint16_t timeout = achordion_timeout(keycode);
-      if (timeout > 0) {
-        achordion_state = STATE_UNSETTLED;
-        // Save info about this key.
-        tap_hold_keycode = keycode;
-        tap_hold_record = *record;
-        hold_timer = record->event.time + timeout;
-        pressed_another_key_before_release = false;
-        eager_mods = 0;
-
-        if (is_mt) {  // Apply mods immediately if they are "eager."
-          const uint8_t mod = mod_config(QK_MOD_TAP_GET_MODS(keycode));
-          if (
-#if defined(CAPS_WORD_ENABLE) && defined(CAPS_WORD_INVERT_ON_SHIFT)
-              // Since eager mods bypass normal event handling, eager Shift does
-              // not work with CAPS_WORD_INVERT_ON_SHIFT. So if this option is
-              // enabled, we don't apply Shift eagerly when Caps Word is on.
-              !(is_caps_word_on() && (mod & MOD_LSFT) != 0) &&
-#endif  // defined(CAPS_WORD_ENABLE) && defined(CAPS_WORD_INVERT_ON_SHIFT)
-              achordion_eager_mod(mod)) {
-            eager_mods = mod;
-            process_eager_mods_action();
-          }
-        }
-
-        dprintf("Achordion: Key 0x%04X pressed.%s\n", keycode,
-                eager_mods ? " Set eager mods." : "");
-        return false;  // Skip default handling.
+#ifdef DEFERRED_EXEC_ENABLE
+// Returns the ms from `time` until the first hold_timer of an unsettled key
+// expires, or 0 if no key is unsettled.
+static int16_t next_hold_timeout(uint16_t time) {
+  int16_t next = 0;
+  for (uint8_t i = 0; i < tap_hold_count; ++i) {
+    if (tap_hold_keys[i].state == STATE_UNSETTLED) {
+      const int16_t remaining =
+          (int16_t)(tap_hold_keys[i].hold_timer - time);
+      if (!next || remaining < next) {
+        next = remaining > 0 ? remaining : 1;
       }
     }
+  }
+  return next;
+}
 
+static uint32_t hold_timeout_callback(uint32_t trigger_time, void* cb_arg) {
+  SCAN_PROFILE_SCOPE(SCAN_PROFILE_ACHORDION_TIMERS);
+  settle_expired_holds();
+  // QMK adds the delay to trigger_time, which is earlier than now if the
+  // callback ran late.
+  const int16_t next = next_hold_timeout((uint16_t)trigger_time);
+  if (next) {
+    return next;  // Run again when the next unsettled key expires.
+  }
+  hold_token = INVALID_DEFERRED_TOKEN;
+  return 0;
+}
+#endif  // DEFERRED_EXEC_ENABLE
+
+// Sets the hold timer of a key that was just added as unsettled. Returns false
+// if it has already expired, which happens when the main loop stalled and QMK
+// hands the key over late; the caller then settles the key as held, as
+// `achordion_task()` would in the same scan.
+static bool start_hold_timer(tap_hold_key_t* key, uint16_t timeout) {
+  key->hold_timer = key->record.event.time + timeout;
+#ifdef DEFERRED_EXEC_ENABLE
+  if ((int16_t)(key->hold_timer - timer_read()) <= 0) {
+    return false;
+  }
+  // One callback serves all keys, moved to whichever expires first. It
+  // checks the timers when it runs, so a key settled meanwhile is skipped.
+  const int16_t delay = next_hold_timeout(timer_read());
+  if (!extend_deferred_exec(hold_token, delay)) {
+    hold_token = defer_exec(delay, hold_timeout_callback, NULL);
+  }
+#endif  // DEFERRED_EXEC_ENABLE
+  return true;
+}
+
+// Starts tracking the press of a tap-hold key that QMK considers held.
+static void press_tap_hold_key(uint16_t keycode, keyrecord_t* record,
+                               uint16_t timeout) {
+  // A key past its timeout settles before the new key joins it, as the
+  // callback would have in this scan.
+  settle_expired_holds();
+
+  bool streak_tap = false;
+  for (uint8_t i = 0; i < tap_hold_count; ++i) {
+    tap_hold_key_t* key = &tap_hold_keys[i];
+    if (key->state != STATE_UNSETTLED) {
+      continue;
+    }
+    // Within a typing streak, unsettled keys are tapped, oldest first, up to
+    // one that isn't. The others stay unsettled, chorded with the new key.
+    if (!is_streak(key, keycode, record)) {
+      break;
+    }
+    record_settle(key, KEY_RECORD_SETTLE_STREAK, TAP_HOLD_STREAK_TAP);
+    settle_as_tap(key);
+    streak_tap = true;
+  }
+  replay_events();
 #ifdef ACHORDION_STREAK
+  if (streak_tap) {
     update_streak_timer(keycode, record);
+  }
+#else
+  (void)streak_tap;
 #endif
-    return true;  // Otherwise, continue with default handling.
-  } else if (record->event.pressed && tap_hold_keycode != keycode) {
-    // Track whether another key was pressed while using a tap-hold key.
-    pressed_another_key_before_release = true;
-  }
-
-  // Release of the active tap-hold key.
-  if (keycode == tap_hold_keycode && !record->event.pressed) {
-    if (eager_mods) {
-      dprintln("Achordion: Key released. Clearing eager mods.");
-      tap_hold_record.event.pressed = false;
-      process_eager_mods_action();
-    } else if (achordion_state == STATE_HOLDING) {
-      dprintln("Achordion: Key released. Plumbing hold release.");
-      tap_hold_record.event.pressed = false;
-      // Plumb hold release event.
-      recursively_process_record(&tap_hold_record, STATE_RELEASED);
-    } else if (!pressed_another_key_before_release) {
-      // No other key was pressed between the press and release of the tap-hold
-      // key, plumb a hold press and then a release.
-      dprintln("Achordion: Key released. Plumbing hold press and release.");
-      recursively_process_record(&tap_hold_record, STATE_HOLDING);
-      tap_hold_record.event.pressed = false;
-      recursively_process_record(&tap_hold_record, STATE_RELEASED);
-    } else {
-      dprintln("Achordion: Key released.");
+
+  // Save info about this key.
+  tap_hold_key_t* key = &tap_hold_keys[tap_hold_count++];
+  key->record = *record;
+  key->keycode = keycode;
+  key->state = STATE_UNSETTLED;
+  key->eager_mods = 0;
+  key->speculated = false;
+#ifdef ACHORDION_SPECULATIVE_TAP
+  if (speculating && same_key(record->event.key, speculated_key)) {
+    speculating = false;
+    key->speculated = true;  // The tap was sent at the press.
+  }
+#endif  // ACHORDION_SPECULATIVE_TAP
+
+  const bool hold_timer_running = start_hold_timer(key, timeout);
+
+  // Apply mods immediately if they are "eager," unless an earlier key is
+  // unsettled, which might still be tapped and must not get these mods, or
+  // the tap was sent ahead, which the Backspace taking it back must not get.
+  if (IS_QK_MOD_TAP(keycode) && !unsettled_before(tap_hold_count - 1) &&
+      !key->speculated) {
+    const uint8_t mod = mod_config(QK_MOD_TAP_GET_MODS(keycode));
+    if (
+#if defined(CAPS_WORD_ENABLE) && defined(CAPS_WORD_INVERT_ON_SHIFT)
+        // Since eager mods bypass normal event handling, eager Shift does not
+        // work with CAPS_WORD_INVERT_ON_SHIFT. So if this option is enabled,
+        // we don't apply Shift eagerly when Caps Word is on.
+        !(is_caps_word_on() && (mod & MOD_LSFT) != 0) &&
+#endif  // defined(CAPS_WORD_ENABLE) && defined(CAPS_WORD_INVERT_ON_SHIFT)
+        achordion_eager_mod(mod)) {
+      key->eager_mods = mod;
+      process_eager_mods_action(key);
     }
+  }
 
-    achordion_state = STATE_RELEASED;
-    tap_hold_keycode = KC_NO;
-    return false;
+  token_log(key->eager_mods ? ACHORDION_LOG_KEY_PRESSED_EAGER
+                            : ACHORDION_LOG_KEY_PRESSED,
+            keycode);
+  if (!hold_timer_running) {
+    record_settle(key, KEY_RECORD_SETTLE_TIMEOUT, TAP_HOLD_TIMEOUT_HOLD);
+    settle_as_hold(key);
+    replay_events();
+  }
+}
+
+// Handles the release of the tracked key at `index`, and stops tracking it.
+static void release_tap_hold_key(uint8_t index) {
+  tap_hold_key_t* key = &tap_hold_keys[index];
+
+  if (key->state == STATE_UNSETTLED) {
+    // Unsettled keys pressed before it had it pressed and released within
+    // them, and settle by it.
+    keyrecord_t press = key->record;
+    for (uint8_t i = 0; i < index; ++i) {
+      if (tap_hold_keys[i].state == STATE_UNSETTLED) {
+        settle_by_next_key(&tap_hold_keys[i], key->keycode, &press, false);
+      }
+    }
+    // A key pressed after it is still unsettled, as any other key press would
+    // have settled them both. It settles the key the same way.
+    if (index + 1 < tap_hold_count) {
+      tap_hold_key_t* next = &tap_hold_keys[index + 1];
+      settle_by_next_key(key, next->keycode, &next->record, false);
+    }
+  }
+
+  if (key->eager_mods) {
+    token_log(ACHORDION_LOG_RELEASED_EAGER, 0);
+    replay_events();  // The release goes after the events queued so far.
+    key->record.event.pressed = false;
+    process_eager_mods_action(key);
+  } else if (key->state == STATE_HOLDING) {
+    token_log(ACHORDION_LOG_RELEASED_HOLD, 0);
+    key->record.event.pressed = false;
+    // Plumb hold release event.
+    queue_replay(&key->record, false);
+  } else if (key->state == STATE_UNSETTLED) {
+    // No other key was pressed between the press and release of the tap-hold
+    // key, plumb a hold press and then a release.
+    token_log(ACHORDION_LOG_RELEASED_HOLD_PRESS, 0);
+    record_settle(key, KEY_RECORD_SETTLE_HOLD, TAP_HOLD_RELEASE_HOLD);
+    take_back_tap(key);
+    queue_replay(&key->record, false);
+    key->record.event.pressed = false;
+    queue_replay(&key->record, false);
+  } else {
+    token_log(ACHORDION_LOG_RELEASED, 0);
+  }
+
+  --tap_hold_count;
+  for (uint8_t i = index; i < tap_hold_count; ++i) {
+    tap_hold_keys[i] = tap_hold_keys[i + 1];
   }
+  replay_events();
+}
+
+bool achordion_is_plumbing(void) { return recursing; }
 
-  if (achordion_state == STATE_UNSETTLED && record->event.pressed) {
+bool process_achordion(uint16_t keycode, keyrecord_t* record) {
+  // Don't process events that Achordion generated.
+  if (recursing) {
+    return true;
+  }
+
+#if TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+  if (pending_release_count) {
+    release_pending_taps_of(keycode, record);
+  }
+#endif  // TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+
+#ifdef ACHORDION_SPECULATIVE_TAP
+  if (speculating && same_key(record->event.key, speculated_key) &&
+      (record->tap.count || !record->event.pressed)) {
+    // QMK tapped the key, whose tap was sent at its press. A release that
+    // isn't a tap is of a key QMK dropped on a waiting buffer overflow, as a
+    // hold is handed over before it.
+    if (!record->event.pressed) {
+      speculating = false;
+    }
 #ifdef ACHORDION_STREAK
-    const uint16_t s_timeout =
-        achordion_streak_chord_timeout(tap_hold_keycode, keycode);
-    const bool is_streak =
-        streak_timer && s_timeout &&
-        !timer_expired(record->event.time, (streak_timer + s_timeout));
+    update_streak_timer(keycode, record);
 #endif
+    return false;
+  }
+#endif  // ACHORDION_SPECULATIVE_TAP
+
+  // Determine whether the current event is for a mod-tap or layer-tap key.
+  const bool is_tap_hold = IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
+  // Check that this is a normal key event, don't act on combos.
+  const bool is_key_event = IS_KEYEVENT(record->event);
+
+  if (!record->event.pressed) {
+    // Release of a tracked tap-hold key.
+    const uint8_t index = find_key(keycode);
+    if (index < tap_hold_count) {
+      release_tap_hold_key(index);
+      return false;
+    }
+  } else if (is_tap_hold && record->tap.count == 0 && is_key_event &&
+             tap_hold_count < ACHORDION_MAX_KEYS) {
+    // A tap-hold key is pressed and considered by QMK as "held".
+    const uint16_t timeout = achordion_timeout(keycode);
+    if (timeout > 0) {
+      press_tap_hold_key(keycode, record, timeout);
+      return false;  // Skip default handling.
+    }
+  }
 
-    // Press event occurred on a key other than the active tap-hold key.
+  if (record->event.pressed && unsettled_before(tap_hold_count)) {
+    // Press event occurred on a key other than the unsettled tap-hold keys.
 
     // If the other key is *also* a tap-hold key and considered by QMK to be
-    // held, then we settle the active key as held. This way, things like
-    // chording multiple home row modifiers will work, but let's our logic
-    // consider simply a single tap-hold key as "active" at a time.
+    // held, but not tracked, then we settle the unsettled keys as held.
     //
-    // Otherwise, we call `achordion_chord()` to determine whether to settle the
-    // tap-hold key as tapped vs. held. We implement the tap or hold by plumbing
-    // events back into the handling pipeline so that QMK features and other
-    // user code can see them. This is done by calling `process_record()`, which
-    // in turn calls most handlers including `process_record_user()`.
-    if (!is_streak &&
-        (!is_key_event || (is_tap_hold && record->tap.count == 0) ||
-         achordion_chord(tap_hold_keycode, &tap_hold_record, keycode,
-                         record))) {
-      settle_as_hold();
+    // Otherwise, we call `achordion_chord()` for each of them, oldest first,
+    // to determine whether to settle it as tapped vs. held. We implement the
+    // tap or hold by plumbing events back into the handling pipeline so that
+    // QMK features and other user code can see them. This is done by calling
+    // `process_record()`, which in turn calls most handlers including
+    // `process_record_user()`.
+    const bool hold =
+        !is_key_event || (is_tap_hold && record->tap.count == 0);
+    bool held = false;
+    bool held_layer_tap = false;
+    for (uint8_t i = 0; i < tap_hold_count; ++i) {
+      tap_hold_key_t* key = &tap_hold_keys[i];
+      if (key->state == STATE_UNSETTLED &&
+          settle_by_next_key(key, keycode, record, hold)) {
+        held = true;
+        held_layer_tap |= IS_QK_LAYER_TAP(key->keycode);
+      }
+    }
 
 #ifdef REPEAT_KEY_ENABLE
-      // Edge case involving LT + Repeat Key: in a sequence of "LT down, other
-      // down" where "other" is on the other layer in the same position as
-      // Repeat or Alternate Repeat, the repeated keycode is set instead of the
-      // the one on the switched-to layer. Here we correct that.
-      if (get_repeat_key_count() != 0 && IS_QK_LAYER_TAP(tap_hold_keycode)) {
-        record->keycode = KC_NO;  // Forget the repeated keycode.
-        clear_weak_mods();
-      }
+    // Edge case involving LT + Repeat Key: in a sequence of "LT down, other
+    // down" where "other" is on the other layer in the same position as
+    // Repeat or Alternate Repeat, the repeated keycode is set instead of the
+    // the one on the switched-to layer. Here we correct that.
+    replay_events();  // The correction below follows the hold press.
+    if (get_repeat_key_count() != 0 && held_layer_tap) {
+      record->keycode = KC_NO;  // Forget the repeated keycode.
+      clear_weak_mods();
+    }
+#else
+    (void)held_layer_tap;
 #endif  // REPEAT_KEY_ENABLE
-    } else {
-      settle_as_tap();
 
 #ifdef ACHORDION_STREAK
+    if (!held) {
       update_streak_timer(keycode, record);
-      if (is_streak && is_key_event && is_tap_hold && record->tap.count == 0) {
-        // If we are in a streak and resolved the current tap-hold key as a tap
-        // consider the next tap-hold key as active to be resolved next.
-        update_streak_timer(tap_hold_keycode, &tap_hold_record);
-        const uint16_t timeout = achordion_timeout(keycode);
-        tap_hold_keycode = keycode;
-        tap_hold_record = *record;
-        hold_timer = record->event.time + timeout;
-        achordion_state = STATE_UNSETTLED;
-        pressed_another_key_before_release = false;
-        return false;
-      }
-#endif
     }
+#else
+    (void)held;
+#endif
 
-    recursively_process_record(record, achordion_state);  // Re-process event.
+    queue_replay(record, false);  // Re-process event.
+    replay_events();
     return false;  // Block the original event.
   }
 
@@ -298,20 +770,201 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
   return true;
 }
 
+#ifdef DEFERRED_EXEC_ENABLE
+// Timeouts run as deferred callbacks, nothing to poll.
+void achordion_task(void) {}
+#else
 void achordion_task(void) {
-  if (achordion_state == STATE_UNSETTLED &&
-      timer_expired(timer_read(), hold_timer)) {
-    settle_as_hold();  // Timeout expired, settle the key as held.
-  }
+  settle_expired_holds();
 
 #ifdef ACHORDION_STREAK
-#define MAX_STREAK_TIMEOUT 800
   if (streak_timer &&
       timer_expired(timer_read(), (streak_timer + MAX_STREAK_TIMEOUT))) {
     streak_timer = 0;  // Expired.
   }
 #endif
 }
+#endif  // DEFERRED_EXEC_ENABLE
+
+#ifdef ACHORDION_OVERLAP_HOLD
+#ifndef ACHORDION_OVERLAP_RATIO
+#define ACHORDION_OVERLAP_RATIO 80
+#endif  // ACHORDION_OVERLAP_RATIO
+
+// The last tap-hold key pressed while none was down, which QMK may still be
+// deciding, and the first key pressed after it.
+static struct {
+  keyrecord_t record;
+  uint16_t keycode;
+  bool pressed;
+} overlap_tap_hold, overlap_other;
+// Set while achordion_overlap_hold_time() runs, as it may ask
+// get_tapping_term(), which asks achordion_overlap_hold().
+static bool overlap_asking = false;
+
+static void track_overlap(uint16_t keycode, keyrecord_t* record) {
+  if (record->event.pressed) {
+    if (!overlap_tap_hold.pressed) {
+      if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        overlap_tap_hold.record = *record;
+        overlap_tap_hold.keycode = keycode;
+        overlap_tap_hold.pressed = true;
+        overlap_other.pressed = false;
+      }
+    } else if (!overlap_other.pressed) {
+      overlap_other.record = *record;
+      overlap_other.keycode = keycode;
+      overlap_other.pressed = true;
+    }
+  } else if (same_key(record->event.key, overlap_tap_hold.record.event.key)) {
+    overlap_tap_hold.pressed = false;
+    overlap_other.pressed = false;
+  } else if (same_key(record->event.key, overlap_other.record.event.key)) {
+    overlap_other.pressed = false;
+  }
+}
+
+bool achordion_overlap_hold(uint16_t keycode, keyrecord_t* record) {
+  if (overlap_asking || !overlap_tap_hold.pressed || !overlap_other.pressed ||
+      !same_key(record->event.key, overlap_tap_hold.record.event.key) ||
+      achordion_timeout(keycode) == 0) {
+    return false;
+  }
+  overlap_asking = true;
+  const uint16_t hold_time = achordion_overlap_hold_time(
+      overlap_tap_hold.keycode, &overlap_tap_hold.record,
+      overlap_other.keycode, &overlap_other.record);
+  overlap_asking = false;
+  if (!hold_time) {
+    return false;
+  }
+  const uint16_t now = timer_read();
+  // Both keys are down from the other key's press on.
+  const uint16_t both = TIMER_DIFF_16(now, overlap_other.record.event.time);
+  const uint16_t held = TIMER_DIFF_16(now, overlap_tap_hold.record.event.time);
+  if (both >= hold_time) {
+    return true;
+  }
+  // Or once they have been down together for most of the tap-hold key's press.
+  return both &&
+         (uint32_t)both * 100 >= (uint32_t)held * ACHORDION_OVERLAP_RATIO;
+}
+#endif  // ACHORDION_OVERLAP_HOLD
+
+#ifdef ACHORDION_STREAK_TAP_ON_PRESS
+// Keys tapped at their press, until their release.
+static bool tapped_on_press[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t tapped_on_press_count = 0;
+
+// Plumbs the press or release of a tap-hold key as a tap event.
+static void plumb_tap_event(uint16_t keycode, const keyrecord_t* record) {
+#if TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+  if (pending_release_count) {
+    release_pending_taps_of(keycode, record);
+  }
+#endif  // TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+  keyrecord_t tap = *record;
+  tap.tap.count = 1;
+  queue_replay(&tap, tap.event.pressed);
+  replay_events();
+}
+
+// Within a typing streak, taps a tap-hold key at its press, as fast as a
+// plain key, and plumbs its release as the tap release. Returns true if it
+// did, and QMK's tap-hold handling is to skip the event.
+static bool streak_tap_on_press(uint16_t keycode, keyrecord_t* record) {
+  bool* tapped = &tapped_on_press[record->event.key.row][record->event.key.col];
+  if (!record->event.pressed) {
+    if (!*tapped) {
+      return false;
+    }
+    *tapped = false;
+    --tapped_on_press_count;
+    token_log(ACHORDION_LOG_TAP_RELEASE, 0);
+    plumb_tap_event(keycode, record);
+    update_streak_timer(keycode, record);
+    return true;
+  }
+  // Another tap-hold key down may still be decided, by QMK or Achordion, and
+  // its outcome must reach the host first.
+  if (!(IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) ||
+      tap_hold_down || !achordion_timeout(keycode) ||
+      !is_streak_press(keycode, record)) {
+    return false;
+  }
+  const tap_hold_key_t key = {.record = *record, .keycode = keycode};
+  record_settle(&key, KEY_RECORD_SETTLE_STREAK, TAP_HOLD_STREAK_TAP);
+  token_log(ACHORDION_LOG_STREAK_TAP, keycode);
+  *tapped = true;
+  ++tapped_on_press_count;
+  plumb_tap_event(keycode, record);
+  update_streak_timer(keycode, record);
+  return true;
+}
+#endif  // ACHORDION_STREAK_TAP_ON_PRESS
+
+#ifdef ACHORDION_SPECULATIVE_TAP
+// Sends the tap of a tap-hold key at its press, ahead of QMK's tap-hold
+// handling, unless another tap-hold key is down, whose outcome must reach the
+// host first, or mods other than Shift are on, which would turn the tap into
+// a shortcut that Backspace can't take back.
+static void speculate(uint16_t keycode, keyrecord_t* record) {
+  if (!(IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) ||
+      tap_hold_down || !achordion_timeout(keycode) ||
+      ((get_mods() | get_weak_mods()) & ~MOD_MASK_SHIFT) ||
+      !achordion_speculative_tap(keycode, record)) {
+    return;
+  }
+#if TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+  if (pending_release_count) {
+    release_pending_taps_of(keycode, record);
+  }
+#endif  // TAP_CODE_DELAY > 0 && defined(DEFERRED_EXEC_ENABLE)
+  token_log(ACHORDION_LOG_SPECULATIVE_TAP, keycode);
+  const tap_hold_key_t key = {.record = *record, .keycode = keycode};
+  plumb_tap(&key);
+  replay_events();
+  speculated_key = record->event.key;
+  speculating = true;
+}
+#endif  // ACHORDION_SPECULATIVE_TAP
+
+bool pre_process_achordion(uint16_t keycode, keyrecord_t* record) {
+  if (!IS_KEYEVENT(record->event)) {
+    return true;
+  }
+#ifdef ACHORDION_SPECULATIVE_TAP
+  // QMK settles the key by its release at the latest. If the key is up and
+  // still speculated, QMK dropped it on a waiting buffer overflow.
+  if (speculating &&
+      !tap_hold_pressed[speculated_key.row][speculated_key.col]) {
+    speculating = false;
+  }
+#endif  // ACHORDION_SPECULATIVE_TAP
+#ifdef ACHORDION_STREAK_TAP_ON_PRESS
+  if (streak_tap_on_press(keycode, record)) {
+    return false;
+  }
+#endif  // ACHORDION_STREAK_TAP_ON_PRESS
+  bool* pressed =
+      &tap_hold_pressed[record->event.key.row][record->event.key.col];
+  if (record->event.pressed) {
+#ifdef ACHORDION_SPECULATIVE_TAP
+    speculate(keycode, record);
+#endif  // ACHORDION_SPECULATIVE_TAP
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+      *pressed = true;
+      ++tap_hold_down;
+    }
+  } else if (*pressed) {
+    *pressed = false;
+    --tap_hold_down;
+  }
+#ifdef ACHORDION_OVERLAP_HOLD
+  track_overlap(keycode, record);
+#endif  // ACHORDION_OVERLAP_HOLD
+  return true;
+}
 
 // Returns true if `pos` on the left hand of the keyboard, false if right.
 static bool on_left_hand(keypos_t pos) {
@@ -338,11 +991,38 @@ __attribute__((weak)) bool achordion_chord(uint16_t tap_hold_keycode,
   return achordion_opposite_hands(tap_hold_record, other_record);
 }
 
+#ifdef ACHORDION_OVERLAP_HOLD
+// By default, the pairs that achordion_chord() holds are held once they
+// overlap for half the tap-hold key's tapping term, and the others are left to
+// the tapping term.
+__attribute__((weak)) uint16_t achordion_overlap_hold_time(
+    uint16_t tap_hold_keycode, keyrecord_t* tap_hold_record,
+    uint16_t other_keycode, keyrecord_t* other_record) {
+  return achordion_chord(tap_hold_keycode, tap_hold_record, other_keycode,
+                         other_record)
+             ? get_tapping_term(tap_hold_keycode, tap_hold_record) / 2
+             : 0;
+}
+#endif  // ACHORDION_OVERLAP_HOLD
+
 // By default, the timeout is 1000 ms for all keys.
 __attribute__((weak)) uint16_t achordion_timeout(uint16_t tap_hold_keycode) {
   return 1000;
 }
 
+#ifdef ACHORDION_SPECULATIVE_TAP
+// By default, only mod-taps that type a letter send their tap ahead, as
+// Backspace takes back exactly one character.
+__attribute__((weak)) bool achordion_speculative_tap(
+    uint16_t tap_hold_keycode, keyrecord_t* tap_hold_record) {
+  if (!IS_QK_MOD_TAP(tap_hold_keycode)) {
+    return false;
+  }
+  const uint16_t tap_keycode = QK_MOD_TAP_GET_TAP_KEYCODE(tap_hold_keycode);
+  return KC_A <= tap_keycode && tap_keycode <= KC_Z;
+}
+#endif  // ACHORDION_SPECULATIVE_TAP
+
 // By default, Shift and Ctrl mods are eager, and Alt and GUI are not.
 __attribute__((weak)) bool achordion_eager_mod(uint8_t mod) {
   return (mod & (MOD_LALT | MOD_LGUI)) == 0;
@@ -36,8 +36,16 @@
  *  * Timeout: If no other key press occurs within a timeout, the tap-hold key
  *    is settled as held. This is customizable with `achordion_timeout()`.
  *
+ * Several tap-hold keys can be unsettled at once, up to `ACHORDION_MAX_KEYS`
+ * (default 4). A tap-hold key pressed while others are unsettled doesn't settle
+ * them; each one is settled by the next key that isn't one of them, by its own
+ * timeout, or when it is released. So mods chorded on two tap-hold keys, like
+ * Ctrl+Shift, are each decided by the key they modify. Eager mods only apply
+ * to a key pressed while no other key is unsettled.
+ *
  * Achordion only changes the behavior when QMK considered the key held. It
- * changes some would-be holds to taps, but no taps to holds.
+ * changes some would-be holds to taps, but no taps to holds, except that with
+ * ACHORDION_OVERLAP_HOLD it can end QMK's tapping term early.
  *
  * @note Some QMK features handle events before the point where Achordion can
  * intercept them, particularly: Combos, Key Lock, and Dynamic Macros. It's
@@ -72,6 +80,26 @@ extern "C" {
  */
 bool process_achordion(uint16_t keycode, keyrecord_t* record);
 
+/**
+ * Returns true while Achordion plumbs the events of its decisions back into
+ * `process_record()`, so that other handlers can tell them from QMK's.
+ */
+bool achordion_is_plumbing(void);
+
+/**
+ * Pre-processing handler for Achordion, which sees key events before QMK's
+ * tap-hold handling. ACHORDION_SPECULATIVE_TAP, ACHORDION_STREAK_TAP_ON_PRESS
+ * and ACHORDION_OVERLAP_HOLD need it. Call it from `pre_process_record_user()`
+ * as
+ *
+ *     bool pre_process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       return pre_process_achordion(keycode, record);
+ *     }
+ *
+ * @return False if Achordion handled the event, and QMK is to skip it.
+ */
+bool pre_process_achordion(uint16_t keycode, keyrecord_t* record);
+
 /**
  * Matrix task function for Achordion.
  *
@@ -80,6 +108,10 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record);
  *     void matrix_scan_user(void) {
  *       achordion_task();
  *     }
+ *
+ * With `DEFERRED_EXEC_ENABLE = yes` in rules.mk, the hold timeout and the
+ * typing streak expiry are deferred callbacks instead, scheduled when a
+ * tap-hold key is pressed, and this function does nothing; no need to call it.
  */
 void achordion_task(void);
 
@@ -149,6 +181,41 @@ uint16_t achordion_timeout(uint16_t tap_hold_keycode);
  */
 bool achordion_eager_mod(uint8_t mod);
 
+/**
+ * Send the tap of a tap-hold key ahead of its decision by defining
+ * ACHORDION_SPECULATIVE_TAP.
+ *
+ *    #define ACHORDION_SPECULATIVE_TAP
+ *
+ * and call `pre_process_achordion()`. When the key is pressed, ahead of QMK's
+ * tap-hold handling, its tap is pressed and released right away, so the
+ * character shows up as fast as a plain key's. If QMK then taps the key, that
+ * tap is skipped. If the key settles as held, by `achordion_chord()`, its
+ * timeout or a lone release, a Backspace takes the character back before the
+ * hold press, so a shortcut types and erases its character first. Decisions
+ * are unchanged; only the tap is sent sooner.
+ *
+ * The tap is sent only while no other tap-hold key is down and no mods but
+ * Shift are on. Choose the keys in your keymap.c with the callback
+ *
+ *    bool achordion_speculative_tap(uint16_t tap_hold_keycode,
+ *                                   keyrecord_t* tap_hold_record) {
+ *      // Conditions...
+ *    }
+ *
+ * The default accepts mod-taps whose tap is a letter, since Backspace takes
+ * back one character. Return false, for instance, while the host is not in a
+ * text field, where a letter can be a command.
+ *
+ * @param tap_hold_keycode Keycode of the tap-hold key.
+ * @param tap_hold_record keyrecord_t from the tap-hold press event.
+ * @return True if the tap should be sent ahead.
+ */
+#ifdef ACHORDION_SPECULATIVE_TAP
+bool achordion_speculative_tap(uint16_t tap_hold_keycode,
+                               keyrecord_t* tap_hold_record);
+#endif
+
 /**
  * Returns true if the args come from keys on opposite hands.
  *
@@ -177,6 +244,19 @@ bool achordion_opposite_hands(const keyrecord_t* tap_hold_record,
  *        uint16_t tap_hold_keycode, uint16_t next_keycode) {
  *      return 200;  // Default of 200 ms.
  *    }
+ *
+ * A tap-hold key in a streak is still settled at the next key press, after
+ * QMK's tapping term. To tap it as soon as it is pressed instead, as fast as a
+ * plain key, also define
+ *
+ *    #define ACHORDION_STREAK_TAP_ON_PRESS
+ *
+ * and call `pre_process_achordion()`. The key is then tapped at its press,
+ * ahead of QMK's tap-hold handling, if `achordion_streak_continue()` accepts
+ * it and it is pressed within `achordion_streak_chord_timeout()` of the
+ * streak, called with `next_keycode` KC_NO since no next key is known yet,
+ * and no other tap-hold key is down. It can't become a hold however long it
+ * is held, so a shortcut right after typing needs a pause of that long first.
  */
 #ifdef ACHORDION_STREAK
 uint16_t achordion_streak_chord_timeout(uint16_t tap_hold_keycode,
@@ -188,6 +268,64 @@ bool achordion_streak_continue(uint16_t keycode);
 uint16_t achordion_streak_timeout(uint16_t tap_hold_keycode);
 #endif
 
+/**
+ * Settle a tap-hold key held with another key as held before QMK's tapping
+ * term ends by defining ACHORDION_OVERLAP_HOLD. QMK doesn't hand Achordion a
+ * tap-hold key until the tapping term ends, or, with PERMISSIVE_HOLD, until
+ * the other key is released within it, so a shortcut waits for one of them.
+ *
+ * Enable it along with per-key tapping terms in config.h:
+ *
+ *    #define ACHORDION_OVERLAP_HOLD
+ *    #define TAPPING_TERM_PER_KEY
+ *
+ * and, along with `pre_process_achordion()`, call it from your keymap.c:
+ *
+ *    uint16_t get_tapping_term(uint16_t keycode, keyrecord_t* record) {
+ *      return achordion_overlap_hold(keycode, record) ? 0 : TAPPING_TERM;
+ *    }
+ *
+ * The tapping term of a tap-hold key then ends early once the first key
+ * pressed after it has been down with it for `achordion_overlap_hold_time()`,
+ * or for ACHORDION_OVERLAP_RATIO percent (default 80) of the time the
+ * tap-hold key has been down. Achordion settles the key as usual from there,
+ * so `achordion_chord()` and typing streaks still apply. A roll releases the
+ * tap-hold key before either, and stays a tap.
+ *
+ * Keys pressed g ms apart reach the ratio r after r / (100 - r) * g ms of
+ * overlap: 4 times the gap at 80, but only 1.5 times at 60. A fast roll
+ * overlaps for about twice its gap, so keep the ratio well above 67, and the
+ * overlap time above a few tens of ms. Rolls are closer together than chords,
+ * so the ratio holds a chord pressed nearly at once earlier than the overlap
+ * time does.
+ *
+ * Define the overlap per pair of keys with the callback
+ *
+ *    uint16_t achordion_overlap_hold_time(uint16_t tap_hold_keycode,
+ *                                         keyrecord_t* tap_hold_record,
+ *                                         uint16_t other_keycode,
+ *                                         keyrecord_t* other_record) {
+ *      // ...
+ *    }
+ *
+ * It returns the overlap in ms, or 0 to leave the pair to the tapping term;
+ * the ratio only applies to pairs with an overlap. The default is half of the
+ * tap-hold key's `get_tapping_term()` for the pairs `achordion_chord()` holds,
+ * and 0 for the others. `achordion_overlap_hold()` returns false while the
+ * callback runs, so the callback can ask `get_tapping_term()` for the term
+ * without the overlap. Keys with an `achordion_timeout()` of 0 are left to the
+ * tapping term too.
+ */
+#ifdef ACHORDION_OVERLAP_HOLD
+/** Returns true if tap-hold `record` is to end its tapping term now. */
+bool achordion_overlap_hold(uint16_t keycode, keyrecord_t* record);
+
+uint16_t achordion_overlap_hold_time(uint16_t tap_hold_keycode,
+                                     keyrecord_t* tap_hold_record,
+                                     uint16_t other_keycode,
+                                     keyrecord_t* other_record);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
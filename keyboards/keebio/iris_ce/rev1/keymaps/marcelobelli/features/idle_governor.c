@@ -0,0 +1,82 @@
+/**
+ * @file idle_governor.c
+ * @brief Idle Governor implementation
+ */
+
+#include "idle_governor.h"
+
+#ifdef SPLIT_KEYBOARD
+#    include "transactions.h"
+#endif
+
+idle_governor_stats_t idle_governor_stats;
+
+static bool     idle          = false;
+static uint32_t last_activity = 0;
+static uint32_t idle_since    = 0;
+#ifdef SPLIT_KEYBOARD
+static bool     sync_pending = false;
+static uint32_t last_sync    = 0;
+
+// Runs on the other half.
+static void receive_state(uint8_t in_len, const void *in_data, uint8_t out_len, void *out_data) {
+    if (in_len == sizeof(idle)) {
+        idle = *(const bool *)in_data;
+    }
+}
+#endif
+
+static void set_idle(bool value) {
+    idle = value;
+    if (value) {
+        idle_since = timer_read32();
+        idle_governor_stats.idle_entries++;
+    } else {
+        idle_governor_stats.idle_time += timer_elapsed32(idle_since);
+    }
+#ifdef SPLIT_KEYBOARD
+    sync_pending = true;
+#endif
+}
+
+void idle_governor_init(void) {
+    idle          = false;
+    last_activity = timer_read32();
+#ifdef SPLIT_KEYBOARD
+    sync_pending = true;
+    transaction_register_rpc(RPC_ID_USER_IDLE_GOVERNOR, receive_state);
+#endif
+}
+
+void idle_governor_activity(void) {
+    last_activity = timer_read32();
+    if (idle) {
+        set_idle(false);
+    }
+}
+
+void idle_governor_task(void) {
+#ifdef SPLIT_KEYBOARD
+    if (!is_keyboard_master()) {
+        return;
+    }
+#endif
+    // Runs every scan: one timer read for both checks.
+    const uint32_t now = timer_read32();
+    if (!idle && TIMER_DIFF_32(now, last_activity) >= IDLE_GOVERNOR_TIMEOUT) {
+        set_idle(true);
+    }
+#ifdef SPLIT_KEYBOARD
+    if (sync_pending || TIMER_DIFF_32(now, last_sync) >= IDLE_GOVERNOR_SYNC_INTERVAL) {
+        if (transaction_rpc_send(RPC_ID_USER_IDLE_GOVERNOR, sizeof(idle), &idle)) {
+            sync_pending = false;
+            idle_governor_stats.syncs++;
+        }
+        last_sync = now;
+    }
+#endif
+}
+
+bool idle_governor_is_idle(void) {
+    return idle;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file idle_governor.h
+ * @brief Idle Governor, backs off periodic work while nobody is typing.
+ *
+ * Overview
+ * --------
+ *
+ * Tracks the time of the last key event seen by `process_record_user()`.
+ * After `IDLE_GOVERNOR_TIMEOUT` ms without one, the board is idle, and the
+ * code that asks `idle_governor_is_idle()` backs off:
+ *
+ *   - the breathing effect redraws 8x less often,
+ *   - the layer indicators skip the brightness check and only rebuild their
+ *     cached colors when the layer changes, as when Layer Lock times out.
+ *
+ * The next key event ends idle before anything else in `process_record_user()`
+ * sees it, so the first keypress is handled at full rate.
+ *
+ * Split keyboards
+ * ---------------
+ *
+ * Only the master sees key events. It sends the idle state to the other half
+ * with a user RPC on every transition, and again every
+ * `IDLE_GOVERNOR_SYNC_INTERVAL` ms in case the other half restarted, so both
+ * halves' effects and indicators follow the same state. Add the transaction
+ * ID in config.h:
+ *
+ *     #define SPLIT_TRANSACTION_IDS_USER RPC_ID_USER_IDLE_GOVERNOR
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifndef IDLE_GOVERNOR_TIMEOUT
+#    define IDLE_GOVERNOR_TIMEOUT 10000
+#endif
+
+#ifndef IDLE_GOVERNOR_SYNC_INTERVAL
+#    define IDLE_GOVERNOR_SYNC_INTERVAL 1000
+#endif
+
+typedef struct {
+    // Transitions into idle.
+    uint32_t idle_entries;
+    // Total time spent idle, up to the last wake, in ms.
+    uint32_t idle_time;
+    // State messages sent to the other half.
+    uint32_t syncs;
+} idle_governor_stats_t;
+
+extern idle_governor_stats_t idle_governor_stats;
+
+/** Resets to active and registers the split RPC. Call from `keyboard_post_init_user()`. */
+void idle_governor_init(void);
+
+/**
+ * Records input. Call first thing in `process_record_user()`:
+ *
+ *     if (IS_KEYEVENT(record->event)) {
+ *         idle_governor_activity();
+ *     }
+ */
+void idle_governor_activity(void);
+
+/** Enters idle after the timeout and syncs the other half. Call from `housekeeping_task_user()`. */
+void idle_governor_task(void);
+
+/** Returns true while the board is idle. */
+bool idle_governor_is_idle(void);
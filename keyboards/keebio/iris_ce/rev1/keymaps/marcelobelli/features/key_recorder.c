@@ -0,0 +1,83 @@
+/**
+ * @file key_recorder.c
+ * @brief Key Recorder implementation
+ */
+
+#include "key_recorder.h"
+
+#ifdef RAW_ENABLE
+#    include <string.h>
+#    include "raw_hid.h"
+#endif
+
+static key_record_t records[KEY_RECORDER_SIZE];
+// Next slot to write. Once `wrapped`, it is also the oldest record.
+static uint16_t head    = 0;
+static bool     wrapped = false;
+
+static void append(uint16_t time, keypos_t key, uint8_t kind) {
+    key_record_t *r = &records[head];
+    r->time         = time;
+    r->pos          = key.row << 4 | key.col;
+    r->flags        = get_highest_layer(layer_state) << 4 | kind;
+    if (++head == KEY_RECORDER_SIZE) {
+        head    = 0;
+        wrapped = true;
+    }
+}
+
+void key_recorder_event(const keyrecord_t *record) {
+    if (IS_KEYEVENT(record->event)) {
+        append(record->event.time, record->event.key, record->event.pressed ? KEY_RECORD_DOWN : KEY_RECORD_UP);
+    }
+}
+
+void key_recorder_settle(keypos_t key, uint8_t kind) {
+    append(timer_read(), key, kind);
+}
+
+void key_recorder_clear(void) {
+    head    = 0;
+    wrapped = false;
+}
+
+void key_recorder_dump(void) {
+    const uint16_t count = wrapped ? KEY_RECORDER_SIZE : head;
+    const uint16_t first = wrapped ? head : 0;
+#ifdef RAW_ENABLE
+    uint8_t packet[RAW_EPSIZE];
+    for (uint16_t i = 0; i < count;) {
+        uint8_t n = 0;
+        memset(packet, 0, sizeof(packet));
+        packet[0] = KEY_RECORDER_RAW_HID_ID;
+        while (i < count && 2 + (n + 1) * sizeof(key_record_t) <= sizeof(packet)) {
+            memcpy(&packet[2 + n * sizeof(key_record_t)], &records[(first + i) & (KEY_RECORDER_SIZE - 1)], sizeof(key_record_t));
+            n++;
+            i++;
+        }
+        packet[1] = n;
+        raw_hid_send(packet, sizeof(packet));
+    }
+#else
+    uprintf("key_recorder: begin %u\n", count);
+    for (uint16_t i = 0; i < count; i += 8) {
+        uprintf("key_recorder:");
+        for (uint16_t j = i; j < count && j < i + 8; j++) {
+            const key_record_t *r = &records[(first + j) & (KEY_RECORDER_SIZE - 1)];
+            uprintf(" %04X%02X%02X", r->time, r->pos, r->flags);
+        }
+        uprintf("\n");
+    }
+    uprintf("key_recorder: end\n");
+#endif
+}
+
+bool process_key_recorder(uint16_t keycode, keyrecord_t *record, uint16_t dump_keycode) {
+    if (keycode != dump_keycode) {
+        return true;
+    }
+    if (record->event.pressed) {
+        key_recorder_dump();
+    }
+    return false;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file key_recorder.h
+ * @brief Key Recorder, a RAM ring buffer of recent key events.
+ *
+ * Overview
+ * --------
+ *
+ * Keeps the last `KEY_RECORDER_SIZE` matrix events and Achordion settle
+ * decisions in a fixed ring buffer of 4-byte records, so that a misfired home
+ * row mod can be dumped right after it happens and replayed offline in the
+ * host simulator. Recording is a handful of stores per event; nothing is
+ * printed until the dump key is pressed.
+ *
+ * Enable it in rules.mk:
+ *
+ *     KEY_RECORDER_ENABLE = yes
+ *
+ * and optionally size the buffer in config.h (a power of two):
+ *
+ *     #define KEY_RECORDER_SIZE 512  // 2 KB of RAM.
+ *
+ * Dump format
+ * -----------
+ *
+ * With `RAW_ENABLE`, the dump goes out as raw HID packets: byte 0 is
+ * `KEY_RECORDER_RAW_HID_ID`, byte 1 the number of records in the packet, then
+ * up to 7 records. Otherwise it is printed on the console (`CONSOLE_ENABLE`) as
+ *
+ *     key_recorder: begin <count>
+ *     key_recorder: TTTTPPFF TTTTPPFF ...
+ *     key_recorder: end
+ *
+ * with each record as 16-bit time, position and flags in hex, oldest first.
+ * `sim/build/tracetool import` turns a captured console log into a .ktr trace.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifndef KEY_RECORDER_SIZE
+#    define KEY_RECORDER_SIZE 256
+#endif
+
+_Static_assert((KEY_RECORDER_SIZE & (KEY_RECORDER_SIZE - 1)) == 0, "KEY_RECORDER_SIZE must be a power of two");
+
+#ifndef KEY_RECORDER_RAW_HID_ID
+#    define KEY_RECORDER_RAW_HID_ID 0x4B
+#endif
+
+/** What a record describes, in the low nibble of `key_record_t.flags`. */
+enum {
+    KEY_RECORD_UP,
+    KEY_RECORD_DOWN,
+    // Achordion settled the tap-hold key at `pos` as tapped.
+    KEY_RECORD_SETTLE_TAP,
+    // Achordion settled the tap-hold key at `pos` as held.
+    KEY_RECORD_SETTLE_HOLD,
+    // The Achordion timeout expired and settled the key as held.
+    KEY_RECORD_SETTLE_TIMEOUT,
+    // Achordion settled the key as tapped because of a typing streak.
+    KEY_RECORD_SETTLE_STREAK,
+};
+
+typedef struct {
+    uint16_t time;  // Low 16 bits of the event time.
+    uint8_t  pos;   // row << 4 | col
+    uint8_t  flags; // Highest active layer << 4 | kind
+} key_record_t;
+
+_Static_assert(sizeof(key_record_t) == 4, "key_record_t must be 4 bytes");
+
+#define KEY_RECORD_KIND(record) ((record).flags & 0x0F)
+#define KEY_RECORD_LAYER(record) ((record).flags >> 4)
+
+/**
+ * Records a matrix event. Call from `pre_process_record_user()`, which sees
+ * each physical event once, before tap-hold handling can delay or replay it:
+ *
+ *     bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+ *         key_recorder_event(record);
+ *         return true;
+ *     }
+ */
+void key_recorder_event(const keyrecord_t *record);
+
+/**
+ * Records a settle decision for the tap-hold key at `key`, stamped with the
+ * current time rather than the triggering event's, so that the distance from
+ * the key's press to its decision is the latency the typist saw.
+ */
+void key_recorder_settle(keypos_t key, uint8_t kind);
+
+/**
+ * Handler for the dump key. Call next to the other feature handlers in
+ * `process_record_user()`, passing the custom keycode that dumps the buffer:
+ *
+ *     if (!process_key_recorder(keycode, record, RECDUMP)) {
+ *         return false;
+ *     }
+ */
+bool process_key_recorder(uint16_t keycode, keyrecord_t *record, uint16_t dump_keycode);
+
+/** Sends the buffered records, oldest first. The buffer is left intact. */
+void key_recorder_dump(void);
+
+/** Discards all buffered records. */
+void key_recorder_clear(void);
@@ -27,8 +27,29 @@ static layer_state_t locked_layers = 0;
 
 // Layer Lock timer to disable layer lock after X seconds inactivity
 #if LAYER_LOCK_IDLE_TIMEOUT > 0
+#ifdef DEFERRED_EXEC_ENABLE
+// Callback that unlocks all layers, pushed back on every key event.
+static deferred_token idle_token = INVALID_DEFERRED_TOKEN;
+
+static uint32_t idle_timeout_callback(uint32_t trigger_time, void* cb_arg) {
+  idle_token = INVALID_DEFERRED_TOKEN;
+  if (locked_layers) {
+    layer_lock_all_off();
+  }
+  return 0;
+}
+
+static void reset_idle_timer(void) {
+  if (!extend_deferred_exec(idle_token, LAYER_LOCK_IDLE_TIMEOUT)) {
+    idle_token = defer_exec(LAYER_LOCK_IDLE_TIMEOUT, idle_timeout_callback,
+                            NULL);
+  }
+}
+#else
 static uint32_t layer_lock_timer = 0;
 
+static void reset_idle_timer(void) { layer_lock_timer = timer_read32(); }
+
 void layer_lock_task(void) {
   if (locked_layers &&
       timer_elapsed32(layer_lock_timer) > LAYER_LOCK_IDLE_TIMEOUT) {
@@ -36,6 +57,7 @@ void layer_lock_task(void) {
     layer_lock_timer = timer_read32();
   }
 }
+#endif  // DEFERRED_EXEC_ENABLE
 #endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
 
 // Handles an event on an `MO` or `TT` layer switch key.
@@ -51,16 +73,6 @@ static bool handle_mo_or_tt(uint8_t layer, keyrecord_t* record) {
 
 bool process_layer_lock(uint16_t keycode, keyrecord_t* record,
                         uint16_t lock_keycode) {
-#if LAYER_LOCK_IDLE_TIMEOUT > 0
-  layer_lock_timer = timer_read32();
-#endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
-
-  // The intention is that locked layers remain on. If something outside of
-  // this feature turned any locked layers off, unlock them.
-  if ((locked_layers & ~layer_state) != 0) {
-    layer_lock_set_user(locked_layers &= layer_state);
-  }
-
   if (keycode == lock_keycode) {
     if (record->event.pressed) {  // The layer lock key was pressed.
       layer_lock_invert(get_highest_layer(layer_state));
@@ -68,6 +80,17 @@ bool process_layer_lock(uint16_t keycode, keyrecord_t* record,
     return false;
   }
 
+  // With no layer locked, there is neither an idle timer to reset nor a lock
+  // for a layer key to release. Locks are kept in step with layer_state by
+  // `layer_lock_layer_state_set()`, not here.
+  if (!locked_layers) {
+    return true;
+  }
+
+#if LAYER_LOCK_IDLE_TIMEOUT > 0
+  reset_idle_timer();
+#endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
+
   switch (keycode) {
     case QK_MOMENTARY ... QK_MOMENTARY_MAX:  // `MO(layer)` keys.
       return handle_mo_or_tt(QK_MOMENTARY_GET_LAYER(keycode), record);
@@ -108,7 +131,10 @@ bool is_layer_locked(uint8_t layer) {
 
 void layer_lock_invert(uint8_t layer) {
   const layer_state_t mask = (layer_state_t)1 << layer;
-  if ((locked_layers & mask) == 0) {  // Layer is being locked.
+  // Updated before the layer switches, which runs
+  // `layer_lock_layer_state_set()`, so that it sees the new locks.
+  locked_layers ^= mask;
+  if ((locked_layers & mask) != 0) {  // Layer is being locked.
 #ifndef NO_ACTION_ONESHOT
     if (layer == get_oneshot_layer()) {
       reset_oneshot_layer();  // Reset so that OSL doesn't turn layer off.
@@ -116,12 +142,12 @@ void layer_lock_invert(uint8_t layer) {
 #endif  // NO_ACTION_ONESHOT
     layer_on(layer);
 #if LAYER_LOCK_IDLE_TIMEOUT > 0
-    layer_lock_timer = timer_read32();
+    reset_idle_timer();
 #endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
   } else {  // Layer is being unlocked.
     layer_off(layer);
   }
-  layer_lock_set_user(locked_layers ^= mask);
+  layer_lock_set_user(locked_layers);
 }
 
 // Implement layer_lock_on/off by deferring to layer_lock_invert.
@@ -138,9 +164,19 @@ void layer_lock_off(uint8_t layer) {
 }
 
 void layer_lock_all_off(void) {
-  layer_and(~locked_layers);
+  const layer_state_t unlocked = locked_layers;
   locked_layers = 0;
+  layer_and(~unlocked);
   layer_lock_set_user(locked_layers);
 }
 
+layer_state_t layer_lock_layer_state_set(layer_state_t state) {
+  // The intention is that locked layers remain on. If something outside of
+  // this feature turned any locked layers off, unlock them.
+  if ((locked_layers & ~state) != 0) {
+    layer_lock_set_user(locked_layers &= state);
+  }
+  return state;
+}
+
 __attribute__((weak)) void layer_lock_set_user(layer_state_t locked_layers) {}
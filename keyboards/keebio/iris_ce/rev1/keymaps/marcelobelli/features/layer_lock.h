@@ -37,6 +37,13 @@
  *
  * Tapping the Layer Lock key again unlocks and turns off the layer.
  *
+ * Call `layer_lock_layer_state_set()` from `layer_state_set_user()`, so that
+ * locks follow layers turned off by other means:
+ *
+ *     layer_state_t layer_state_set_user(layer_state_t state) {
+ *       return layer_lock_layer_state_set(state);
+ *     }
+ *
  * @note When a layer is "locked", other layer keys such as `TO(layer)` or
  * manually calling `layer_off(layer)` will override and unlock the layer.
  *
@@ -49,7 +56,9 @@
  *
  *     #define LAYER_LOCK_IDLE_TIMEOUT 60000  // Turn off after 60 seconds.
  *
- * and call `layer_lock_task()` from your `matrix_scan_user()` in keymap.c:
+ * With `DEFERRED_EXEC_ENABLE = yes` in rules.mk, the timeout is a deferred
+ * callback, pushed back on every key event while a layer is locked. Otherwise,
+ * call `layer_lock_task()` from your `matrix_scan_user()` in keymap.c:
  *
  *     void matrix_scan_user(void) {
  *       layer_lock_task();
@@ -99,6 +108,12 @@ void layer_lock_off(uint8_t layer);
 /** Unlocks and turns off all locked layers. */
 void layer_lock_all_off(void);
 
+/**
+ * Unlocks the locked layers that are off in `state`, and returns `state`. Call
+ * from `layer_state_set_user()`.
+ */
+layer_state_t layer_lock_layer_state_set(layer_state_t state);
+
 /** Toggles whether `layer` is locked. */
 void layer_lock_invert(uint8_t layer);
 
@@ -121,15 +136,15 @@ void layer_lock_set_user(layer_state_t locked_layers);
  * @fn layer_lock_task(void)
  * Matrix task function for Layer Lock.
  *
- * If using `LAYER_LOCK_IDLE_TIMEOUT`, call this function from your
- * `matrix_scan_user()` function in keymap.c. (If no timeout is set, calling
- * `layer_lock_task()` has no effect.)
+ * If using `LAYER_LOCK_IDLE_TIMEOUT` without deferred exec, call this function
+ * from your `matrix_scan_user()` function in keymap.c. (If no timeout is set,
+ * or it is a deferred callback, calling `layer_lock_task()` has no effect.)
  */
-#if LAYER_LOCK_IDLE_TIMEOUT > 0
+#if LAYER_LOCK_IDLE_TIMEOUT > 0 && !defined(DEFERRED_EXEC_ENABLE)
 void layer_lock_task(void);
 #else
 static inline void layer_lock_task(void) {}
-#endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
+#endif  // LAYER_LOCK_IDLE_TIMEOUT > 0 && !defined(DEFERRED_EXEC_ENABLE)
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,97 @@
+/**
+ * @file macro_queue.c
+ * @brief Macro Queue implementation
+ */
+
+#include "macro_queue.h"
+
+#ifndef DEFERRED_EXEC_ENABLE
+#    error "macro_queue: needs DEFERRED_EXEC_ENABLE = yes in rules.mk"
+#endif
+
+static const macro_report_t *queue[MACRO_QUEUE_SIZE];
+static uint8_t               queue_head  = 0;
+static uint8_t               queue_count = 0;
+// Next report of the macro being sent, NULL between macros.
+static const macro_report_t *cursor = NULL;
+// What the last report added, to take it back out for the next.
+static uint8_t        sent_mods    = 0;
+static uint8_t        sent_keycode = KC_NO;
+static deferred_token send_token   = INVALID_DEFERRED_TOKEN;
+
+// Sends the next report. Returns false once the queue is empty.
+static bool send_step(void) {
+    for (;;) {
+        if (cursor) {
+            const uint8_t keycode = pgm_read_byte(&cursor->keycode);
+            if (keycode != MACRO_END) {
+                break;
+            }
+            cursor = NULL;
+        }
+        if (!queue_count) {
+            return false;
+        }
+        cursor     = queue[queue_head];
+        queue_head = (queue_head + 1) % MACRO_QUEUE_SIZE;
+        queue_count--;
+    }
+
+    del_weak_mods(sent_mods);
+    if (sent_keycode != KC_NO) {
+        del_key(sent_keycode);
+    }
+    sent_mods    = pgm_read_byte(&cursor->mods);
+    sent_keycode = pgm_read_byte(&cursor->keycode);
+    add_weak_mods(sent_mods);
+    if (sent_keycode != KC_NO) {
+        add_key(sent_keycode);
+    }
+    send_keyboard_report();
+    cursor++;
+    return true;
+}
+
+static uint32_t send_callback(uint32_t trigger_time, void *cb_arg) {
+    if (send_step()) {
+        return MACRO_QUEUE_INTERVAL;
+    }
+    send_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+void macro_queue_send(const macro_report_t *reports) {
+    if (queue_count == MACRO_QUEUE_SIZE) {
+        macro_queue_flush();
+    }
+    queue[(queue_head + queue_count) % MACRO_QUEUE_SIZE] = reports;
+    queue_count++;
+    if (send_token != INVALID_DEFERRED_TOKEN) {
+        return; // Sending already, this macro follows.
+    }
+    send_step();
+    send_token = defer_exec(MACRO_QUEUE_INTERVAL, send_callback, NULL);
+    if (send_token == INVALID_DEFERRED_TOKEN) { // No free executor.
+        macro_queue_flush();
+    }
+}
+
+void macro_queue_flush(void) {
+    do {
+#if TAP_CODE_DELAY > 0
+        if (sent_keycode != KC_NO) {
+            wait_ms(TAP_CODE_DELAY);
+        }
+#endif
+    } while (send_step());
+}
+
+bool macro_queue_is_busy(void) {
+    return queue_count || (cursor && pgm_read_byte(&cursor->keycode) != MACRO_END);
+}
+
+void process_macro_queue(uint16_t keycode, keyrecord_t *record) {
+    if (record->event.pressed && macro_queue_is_busy()) {
+        macro_queue_flush();
+    }
+}
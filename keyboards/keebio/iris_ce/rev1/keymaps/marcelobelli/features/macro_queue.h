@@ -0,0 +1,73 @@
+/**
+ * @file macro_queue.h
+ * @brief Macro Queue, types macros over the following scans.
+ *
+ * Overview
+ * --------
+ *
+ * `SEND_STRING()` taps every character of its string before it returns, so
+ * the keyboard doesn't scan until the whole string is typed. Macro Queue sends
+ * macros compiled ahead of time into keyboard reports: `macro_queue_send()`
+ * only queues the macro, its first report goes out at once, and a deferred
+ * callback sends the rest, one every `MACRO_QUEUE_INTERVAL` ms, while scanning
+ * goes on.
+ *
+ * Macros are strings in macro_strings.h, which `sim/macrogen` compiles into
+ * macro_reports.h (see there for how reports are shared). Include that in
+ * keymap.c and send a macro by name:
+ *
+ *     case DOUBLE_EQUAL:
+ *         if (record->event.pressed) {
+ *             macro_queue_send(macro_double_equal);
+ *         }
+ *         break;
+ *
+ * Up to `MACRO_QUEUE_SIZE` macros wait their turn; past that, the queue is sent
+ * at once to make room, so nothing is dropped. Needs
+ * `DEFERRED_EXEC_ENABLE = yes` in rules.mk.
+ *
+ * Order with typing
+ * -----------------
+ *
+ * A key pressed while a macro is being typed would otherwise overtake it.
+ * `process_macro_queue()` sends what is left at once before the press is
+ * handled, as `SEND_STRING()` would have. Releases don't wait for the queue.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifndef MACRO_QUEUE_SIZE
+#    define MACRO_QUEUE_SIZE 8
+#endif
+
+#ifndef MACRO_QUEUE_INTERVAL
+#    define MACRO_QUEUE_INTERVAL (TAP_CODE_DELAY > 0 ? TAP_CODE_DELAY : 1)
+#endif
+
+/** One keyboard report of a macro: the mods and at most one key. */
+typedef struct {
+    uint8_t mods;
+    uint8_t keycode;
+} macro_report_t;
+
+/** Keycode of the entry that ends a macro's reports. */
+#define MACRO_END 0xFF
+
+/** Queues `reports`, in PROGMEM, to be sent after the macros already queued. */
+void macro_queue_send(const macro_report_t *reports);
+
+/** Sends what is left of the queue at once. */
+void macro_queue_flush(void);
+
+/** Returns true while a macro is being typed. */
+bool macro_queue_is_busy(void);
+
+/**
+ * Keeps key presses behind the queued macros. Call from
+ * `process_record_user()`, before anything that sends keys:
+ *
+ *     process_macro_queue(keycode, record);
+ */
+void process_macro_queue(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,135 @@
+/**
+ * @file report_diff.c
+ * @brief Report Diff implementation
+ */
+
+#include "report_diff.h"
+#include <string.h>
+
+report_diff_stats_t report_diff_stats;
+
+static host_driver_t     driver;
+static host_driver_t    *next_driver = NULL;
+static report_keyboard_t last_sent;
+static report_keyboard_t held;
+static bool              holding = false;
+// Nesting of report_diff_begin() calls. Reports are only held inside one.
+static uint8_t           batch_depth = 0;
+// Reports went straight to the host before the install, so the first one
+// held after it can't be compared with what the host has.
+static bool              last_sent_known = false;
+
+static bool has_key(const report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true if `to` has a key that `from` doesn't.
+static bool adds_key(const report_keyboard_t *from, const report_keyboard_t *to) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (to->keys[i] != KC_NO && !has_key(from, to->keys[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true if the host can skip the held report and see `next` instead.
+static bool can_merge(const report_keyboard_t *next) {
+    if (!last_sent_known) {
+        return false;
+    }
+    const uint8_t pressed_mods  = held.mods & ~last_sent.mods;
+    const uint8_t released_mods = last_sent.mods & ~held.mods;
+    if ((next->mods & pressed_mods) != pressed_mods || (next->mods & released_mods)) {
+        return false;
+    }
+    // Mods that change reach the host before a key pressed after them, as
+    // they would without Report Diff.
+    if (held.mods != last_sent.mods && adds_key(&held, next)) {
+        return false;
+    }
+    bool pressed = false;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        const uint8_t key = held.keys[i];
+        if (key != KC_NO && !has_key(&last_sent, key)) {
+            if (!has_key(next, key)) {
+                return false; // Pressed and released unseen.
+            }
+            pressed = true;
+        }
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        const uint8_t key = last_sent.keys[i];
+        if (key != KC_NO && !has_key(&held, key) && has_key(next, key)) {
+            return false; // Released and pressed again unseen.
+        }
+    }
+    // Presses stay in order and keep the mods they were pressed with.
+    return !pressed || (next->mods == held.mods && !adds_key(&held, next));
+}
+
+static void send_held(void) {
+    holding = false;
+    if (last_sent_known && memcmp(&held, &last_sent, sizeof(held)) == 0) {
+        report_diff_stats.dropped++;
+        return;
+    }
+    last_sent       = held;
+    last_sent_known = true;
+    next_driver->send_keyboard(&last_sent);
+}
+
+static void send_keyboard(report_keyboard_t *report) {
+    if (holding) {
+        if (can_merge(report)) {
+            report_diff_stats.merged++;
+        } else {
+            send_held();
+        }
+    }
+    held    = *report;
+    holding = true;
+#if TAP_CODE_DELAY > 0
+    send_held();
+#else
+    // QMK waits TAP_HOLD_CAPS_DELAY before releasing a tapped Caps Lock.
+    if (!batch_depth || (has_key(&held, KC_CAPS_LOCK) && !(last_sent_known && has_key(&last_sent, KC_CAPS_LOCK)))) {
+        send_held();
+    }
+#endif
+}
+
+// Wraps the host driver once there is one. QMK sets it in
+// protocol_post_init(), after keyboard_post_init_user(), and a USB reset can
+// set it again.
+static void install(void) {
+    host_driver_t *current = host_get_driver();
+    if (!current || current == &driver) {
+        return;
+    }
+    next_driver          = current;
+    driver               = *current;
+    driver.send_keyboard = send_keyboard;
+    holding         = false;
+    last_sent_known = false;
+    host_set_driver(&driver);
+}
+
+void report_diff_begin(void) {
+    batch_depth++;
+}
+
+void report_diff_end(void) {
+    if (--batch_depth == 0 && holding) {
+        send_held();
+    }
+}
+
+void report_diff_task(void) {
+    install();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file report_diff.h
+ * @brief Report Diff, merges the keyboard reports of one batch.
+ *
+ * Overview
+ * --------
+ *
+ * QMK already drops a keyboard report identical to the one before it, but a
+ * single key event can still send several reports in a row: Achordion
+ * settling a key releases its eager mods, then presses and releases the tap
+ * through separate `process_record()` calls, each ending in a report. The host
+ * polls for one report per interval, so every extra one delays the next.
+ *
+ * Report Diff wraps the host driver and, within a batch of reports, holds the
+ * last one back until the next one arrives or the batch ends. The next report
+ * replaces it when the host can't tell the difference between seeing both or
+ * only the second:
+ *
+ *   - every key and mod the held report pressed is still down,
+ *   - no key or mod the held report released is down again,
+ *   - if the held report changed the mods, the next one presses no key,
+ *     so mods change before the keys pressed after them,
+ *   - if the held report pressed a key, the next one presses no other and
+ *     keeps the same mods, so keys go down in order, each with the mods it
+ *     was pressed with.
+ *
+ * Otherwise the held report is sent first. A held report that ends up equal
+ * to the last one sent is dropped. So a release followed by more releases, or
+ * mods changing in several steps, reach the host as one report, while a
+ * hold's mod and the key it modifies, or a tap's press and release, stay two.
+ *
+ * Batches
+ * -------
+ *
+ * A held report goes out late by any `wait_ms()` before the next report, so
+ * the host would see no gap where the firmware waited. Reports are therefore
+ * only held within a batch, which the keymap opens around a call that sends a
+ * known run of reports with no wait in between, Achordion's here:
+ *
+ *     if (!REPORT_DIFF_BATCH(process_achordion(keycode, record))) {
+ *         return false;
+ *     }
+ *
+ * Batches nest, and the outermost one sends the held report as it ends.
+ * Reports outside a batch go straight through. Inside one, QMK still waits in
+ * two places, and the reports before them go straight through too: with
+ * `TAP_CODE_DELAY`, between a tap's press and release, so no report is held
+ * at all, and `TAP_HOLD_CAPS_DELAY` after a tapped Caps Lock goes down.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+typedef struct {
+    // Reports replaced by the one after them.
+    uint32_t merged;
+    // Held reports dropped as equal to the last one sent.
+    uint32_t dropped;
+} report_diff_stats_t;
+
+extern report_diff_stats_t report_diff_stats;
+
+/**
+ * Installs over the host driver once it is set. Call from
+ * `housekeeping_task_user()`.
+ */
+void report_diff_task(void);
+
+/** Opens a batch, within which reports are held back to be merged. */
+void report_diff_begin(void);
+
+/** Closes a batch. The outermost one sends the held report. */
+void report_diff_end(void);
+
+/** Evaluates `expr` within a batch, and to its value. */
+#define REPORT_DIFF_BATCH(expr)                       \
+    ({                                                \
+        report_diff_begin();                          \
+        __typeof__(expr) report_diff_value_ = (expr); \
+        report_diff_end();                            \
+        report_diff_value_;                           \
+    })
@@ -0,0 +1,150 @@
+/**
+ * @file scan_profiler.c
+ * @brief Scan Profiler implementation
+ */
+
+#include "scan_profiler.h"
+
+#include <string.h>
+
+scan_profile_t scan_profile;
+
+static const char *const stage_names[SCAN_PROFILE_STAGE_COUNT] = {
+    [SCAN_PROFILE_TOKEN_LOG]           = "token_log",
+    [SCAN_PROFILE_ACHORDION_TIMERS]    = "achordion_timers",
+    [SCAN_PROFILE_PROCESS_RECORD_USER] = "process_record_user",
+    [SCAN_PROFILE_ACHORDION]           = "achordion",
+    [SCAN_PROFILE_LAYER_LOCK]          = "layer_lock",
+    [SCAN_PROFILE_MACROS]              = "macros",
+    [SCAN_PROFILE_RGB_INDICATORS]      = "rgb_indicators",
+};
+
+static bool     started       = false;
+// Set by a dump; the stages are cleared on the next scan, after the dump
+// key's own process_record_user() has been counted.
+static bool     reset_pending = false;
+static uint32_t scans         = 0;
+static uint32_t window        = 0;
+// Entries of each stage still running.
+static uint8_t  depth[SCAN_PROFILE_STAGE_COUNT];
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#    define DEMCR (*(volatile uint32_t *)0xE000EDFC)
+#    define DWT_CTRL (*(volatile uint32_t *)0xE0001000)
+#    define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004)
+
+static void counter_start(void) {
+    DEMCR |= 1 << 24; // TRCENA
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1; // CYCCNTENA
+}
+
+uint32_t scan_profiler_cycles(void) {
+    return DWT_CYCCNT;
+}
+
+static uint32_t counter_elapsed(uint32_t start) {
+    return DWT_CYCCNT - start;
+}
+#elif defined(__ARM_ARCH_6M__)
+#    define SYST_CSR (*(volatile uint32_t *)0xE000E010)
+#    define SYST_RVR (*(volatile uint32_t *)0xE000E014)
+#    define SYST_CVR (*(volatile uint32_t *)0xE000E018)
+
+// SysTick counts down and reloads from SYST_RVR.
+static uint32_t period;
+
+static void counter_start(void) {
+    if (!(SYST_CSR & 1)) {
+        SYST_RVR = 0xFFFFFF;
+        SYST_CVR = 0;
+        SYST_CSR = 0x5; // Core clock, no interrupt, enabled.
+    }
+    period = SYST_RVR + 1;
+}
+
+uint32_t scan_profiler_cycles(void) {
+    return SYST_CVR;
+}
+
+static uint32_t counter_elapsed(uint32_t start) {
+    const uint32_t now = SYST_CVR;
+    return now <= start ? start - now : start + period - now;
+}
+#elif defined(__x86_64__) || defined(__i386__)
+static void counter_start(void) {}
+
+uint32_t scan_profiler_cycles(void) {
+    return __builtin_ia32_rdtsc();
+}
+
+static uint32_t counter_elapsed(uint32_t start) {
+    return (uint32_t)__builtin_ia32_rdtsc() - start;
+}
+#else
+#    error "scan_profiler: no cycle counter for this architecture"
+#endif
+
+uint32_t scan_profiler_begin(uint8_t stage) {
+    depth[stage]++;
+    return scan_profiler_cycles();
+}
+
+void scan_profiler_add(uint8_t stage, uint32_t start) {
+    const uint32_t elapsed = counter_elapsed(start);
+    if (--depth[stage]) {
+        return; // Counted by the outer entry.
+    }
+    scan_profile_stage_t *s = &scan_profile.stages[stage];
+    if (s->count == 0 || elapsed < s->min) {
+        s->min = elapsed;
+    }
+    if (elapsed > s->max) {
+        s->max = elapsed;
+    }
+    s->total += elapsed;
+    s->count++;
+}
+
+void scan_profiler_scope_end(const scan_profile_scope_t *scope) {
+    scan_profiler_add(scope->stage, scope->start);
+}
+
+void scan_profiler_task(void) {
+    if (!started) {
+        counter_start();
+        started = true;
+        window  = timer_read32();
+    }
+    if (reset_pending) {
+        memset(scan_profile.stages, 0, sizeof(scan_profile.stages));
+        reset_pending = false;
+    }
+    scans++;
+    const uint32_t elapsed = timer_elapsed32(window);
+    if (elapsed >= 1000) {
+        scan_profile.scans_per_second = scans * 1000 / elapsed;
+        scans                         = 0;
+        window                        = timer_read32();
+    }
+}
+
+void scan_profiler_dump(void) {
+    uprintf("scan_profiler: %lu scans/s\n", (unsigned long)scan_profile.scans_per_second);
+    uprintf("scan_profiler: stage count min avg max\n");
+    for (uint8_t i = 0; i < SCAN_PROFILE_STAGE_COUNT; i++) {
+        const scan_profile_stage_t *s = &scan_profile.stages[i];
+        uprintf("scan_profiler: %s %lu %lu %lu %lu\n", stage_names[i], (unsigned long)s->count, (unsigned long)s->min, (unsigned long)(s->count ? s->total / s->count : 0), (unsigned long)s->max);
+    }
+    reset_pending = true;
+}
+
+bool process_scan_profiler(uint16_t keycode, keyrecord_t *record, uint16_t dump_keycode) {
+    if (keycode != dump_keycode) {
+        return true;
+    }
+    if (record->event.pressed) {
+        scan_profiler_dump();
+    }
+    return false;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file scan_profiler.h
+ * @brief Scan Profiler, per-stage cycle counts of the keymap's hooks.
+ *
+ * Overview
+ * --------
+ *
+ * Counts matrix scans per second and times each stage of the keymap's hooks
+ * with the CPU's cycle counter, keeping count, min, max and total per stage
+ * in the fixed-size `scan_profile`. When the board feels laggy, a dump shows
+ * whether RGB or tap-hold processing is eating the scan budget.
+ *
+ * Enable it in rules.mk:
+ *
+ *     SCAN_PROFILER_ENABLE = yes
+ *
+ * When disabled, the macros below compile to nothing (or to the bare call),
+ * so the instrumented hooks are unchanged.
+ *
+ * Cycle counter
+ * -------------
+ *
+ * ARMv7-M cores use the DWT cycle counter. The RP2040's Cortex-M0+ has none,
+ * so ARMv6-M uses SysTick: if the OS hasn't started it, it is started as a
+ * free-running 24-bit counter at the core clock; if it has, it is read as is,
+ * and a stage must then finish within one SysTick period to be timed right.
+ * On the host (the simulator) the counter is the x86 time stamp counter.
+ *
+ * Dump format
+ * -----------
+ *
+ * The dump key prints on the console (`CONSOLE_ENABLE`) and starts a new
+ * measurement window:
+ *
+ *     scan_profiler: 1024 scans/s
+ *     scan_profiler: stage count min avg max
+ *     scan_profiler: token_log 61440 212 260 1930
+ *     ...
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+/**
+ * Timed stages. Nested stages are also counted in their parents. A stage
+ * entered again while it runs, as process_record_user() is by the events
+ * Achordion replays, is counted once, by its outermost entry.
+ */
+enum scan_profile_stage {
+    // token_log_task(), from matrix_scan_user().
+    SCAN_PROFILE_TOKEN_LOG,
+    // Achordion's deferred callbacks: hold and streak timeouts, and tap
+    // releases under TAP_CODE_DELAY.
+    SCAN_PROFILE_ACHORDION_TIMERS,
+    SCAN_PROFILE_PROCESS_RECORD_USER,
+    // Within process_record_user().
+    SCAN_PROFILE_ACHORDION,
+    SCAN_PROFILE_LAYER_LOCK,
+    SCAN_PROFILE_MACROS,
+    // rgb_matrix_indicators_advanced_user().
+    SCAN_PROFILE_RGB_INDICATORS,
+    SCAN_PROFILE_STAGE_COUNT,
+};
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} scan_profile_stage_t;
+
+typedef struct {
+    scan_profile_stage_t stages[SCAN_PROFILE_STAGE_COUNT];
+    // Scans in the last full second.
+    uint32_t scans_per_second;
+} scan_profile_t;
+
+#ifdef SCAN_PROFILER_ENABLE
+
+extern scan_profile_t scan_profile;
+
+typedef struct {
+    uint8_t  stage;
+    uint32_t start;
+} scan_profile_scope_t;
+
+/** Reads the cycle counter. */
+uint32_t scan_profiler_cycles(void);
+
+/** Enters `stage` and returns the cycle counter. */
+uint32_t scan_profiler_begin(uint8_t stage);
+
+/**
+ * Leaves `stage`, adding the cycles since `start` to it if this was its
+ * outermost entry.
+ */
+void scan_profiler_add(uint8_t stage, uint32_t start);
+
+void scan_profiler_scope_end(const scan_profile_scope_t *scope);
+
+/**
+ * Times the rest of the enclosing block, on every return path:
+ *
+ *     bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+ *         SCAN_PROFILE_SCOPE(SCAN_PROFILE_RGB_INDICATORS);
+ *         ...
+ */
+#    define SCAN_PROFILE_SCOPE(stage) const scan_profile_scope_t scan_profile_scope_ __attribute__((cleanup(scan_profiler_scope_end), unused)) = {(stage), scan_profiler_begin(stage)}
+
+/** Times one expression and evaluates to its value. */
+#    define SCAN_PROFILE(stage, expr)                                      \
+        ({                                                                 \
+            const uint32_t   scan_profile_start_ = scan_profiler_begin(stage); \
+            __typeof__(expr) scan_profile_value_ = (expr);                 \
+            scan_profiler_add((stage), scan_profile_start_);               \
+            scan_profile_value_;                                           \
+        })
+
+/**
+ * Counts scans and starts the cycle counter. Call first thing in
+ * `matrix_scan_user()`.
+ */
+void scan_profiler_task(void);
+
+/**
+ * Handler for the dump key. Call next to the other feature handlers in
+ * `process_record_user()`:
+ *
+ *     if (!process_scan_profiler(keycode, record, PROFDMP)) {
+ *         return false;
+ *     }
+ */
+bool process_scan_profiler(uint16_t keycode, keyrecord_t *record, uint16_t dump_keycode);
+
+/** Prints `scan_profile` and starts a new measurement window. */
+void scan_profiler_dump(void);
+
+#else
+
+#    define SCAN_PROFILE_SCOPE(stage)
+#    define SCAN_PROFILE(stage, expr) (expr)
+
+#endif // SCAN_PROFILER_ENABLE
@@ -0,0 +1,105 @@
+/**
+ * @file tap_hold_stats.c
+ * @brief Tap-Hold Stats implementation
+ */
+
+#include "tap_hold_stats.h"
+#include "achordion.h"
+
+#include <string.h>
+
+static tap_hold_stats_key_t keys[TAP_HOLD_STATS_MAX_KEYS];
+static uint8_t              key_count = 0;
+static uint16_t             dropped   = 0;
+
+uint8_t tap_hold_stats_bucket(uint16_t ms) {
+    uint8_t bucket = 0;
+    while (ms >= 2 && bucket < TAP_HOLD_STATS_BUCKETS - 1) {
+        ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static tap_hold_stats_key_t *find_slot(uint8_t pos) {
+    for (uint8_t i = 0; i < key_count; i++) {
+        if (keys[i].pos == pos) {
+            return &keys[i];
+        }
+    }
+    if (key_count == TAP_HOLD_STATS_MAX_KEYS) {
+        return NULL;
+    }
+    keys[key_count].pos = pos;
+    return &keys[key_count++];
+}
+
+void tap_hold_stats_settle(const keyrecord_t *press, uint8_t outcome) {
+    tap_hold_stats_key_t *key = find_slot(press->event.key.row << 4 | press->event.key.col);
+    if (!key) {
+        if (dropped < UINT16_MAX) {
+            dropped++;
+        }
+        return;
+    }
+    uint16_t *count = &key->counts[outcome][tap_hold_stats_bucket(timer_elapsed(press->event.time))];
+    if (*count < UINT16_MAX) {
+        (*count)++;
+    }
+}
+
+uint8_t tap_hold_stats_key_count(void) {
+    return key_count;
+}
+
+const tap_hold_stats_key_t *tap_hold_stats_keys(void) {
+    return keys;
+}
+
+void tap_hold_stats_clear(void) {
+    memset(keys, 0, sizeof(keys));
+    key_count = 0;
+    dropped   = 0;
+}
+
+void tap_hold_stats_dump(void) {
+    uprintf("tap_hold_stats: begin %u %u\n", key_count, dropped);
+    for (uint8_t i = 0; i < key_count; i++) {
+        for (uint8_t outcome = 0; outcome < TAP_HOLD_OUTCOME_COUNT; outcome++) {
+            const uint16_t *counts = keys[i].counts[outcome];
+            uint8_t         b      = 0;
+            while (b < TAP_HOLD_STATS_BUCKETS && !counts[b]) {
+                b++;
+            }
+            if (b == TAP_HOLD_STATS_BUCKETS) {
+                continue;
+            }
+            uprintf("tap_hold_stats: %02X %X", keys[i].pos, outcome);
+            for (b = 0; b < TAP_HOLD_STATS_BUCKETS; b++) {
+                uprintf(" %04X", counts[b]);
+            }
+            uprintf("\n");
+        }
+    }
+    uprintf("tap_hold_stats: end\n");
+}
+
+bool process_tap_hold_stats(uint16_t keycode, keyrecord_t *record, uint16_t dump_keycode) {
+    if (keycode != dump_keycode) {
+        // QMK's decision shows in the press it sends: a tap's at the key's
+        // release, with the press time kept, or a hold's when it settles.
+        // Achordion counts the holds it tracks and the events it plumbs.
+        if (record->event.pressed && IS_KEYEVENT(record->event) && (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) && !achordion_is_plumbing()) {
+            if (record->tap.count) {
+                tap_hold_stats_settle(record, TAP_HOLD_QMK_TAP);
+            } else if (!achordion_timeout(keycode)) {
+                tap_hold_stats_settle(record, TAP_HOLD_QMK_HOLD);
+            }
+        }
+        return true;
+    }
+    if (record->event.pressed) {
+        tap_hold_stats_dump();
+    }
+    return false;
+}
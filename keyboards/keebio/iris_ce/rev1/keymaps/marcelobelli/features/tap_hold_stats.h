@@ -0,0 +1,108 @@
+/**
+ * @file tap_hold_stats.h
+ * @brief Tap-Hold Stats, per-key histograms of tap-hold settle latency.
+ *
+ * Overview
+ * --------
+ *
+ * For each tap-hold key, counts how long it took from the key's press to its
+ * tap or hold decision, split by what decided it: Achordion, or QMK alone for
+ * taps within the tapping term and keys Achordion bypasses. Latencies go into
+ * log2 buckets of 16-bit counters, so the RAM cost is fixed however long the
+ * board runs, and the dump shows whether e.g. streak taps settle in 100 ms
+ * while chord holds take 300 ms on the same key.
+ *
+ * Enable it in rules.mk:
+ *
+ *     TAP_HOLD_STATS_ENABLE = yes
+ *
+ * and optionally set how many keys are tracked in config.h:
+ *
+ *     #define TAP_HOLD_STATS_MAX_KEYS 16
+ *
+ * Keys get a slot the first time they settle. Settles of keys past the last
+ * slot are only counted in `dropped`.
+ *
+ * Buckets
+ * -------
+ *
+ * Bucket 0 holds 0-1 ms, bucket b (1 to `TAP_HOLD_STATS_BUCKETS` - 2) holds
+ * 2^b to 2^(b+1) - 1 ms, and the last bucket everything from 2^11 ms up.
+ * Counters stop at 0xFFFF.
+ *
+ * Dump format
+ * -----------
+ *
+ * The dump key prints on the console (`CONSOLE_ENABLE`), one line per key and
+ * outcome with any counts, then leaves the counters intact:
+ *
+ *     tap_hold_stats: begin <keys> <dropped>
+ *     tap_hold_stats: PP O CCCC CCCC ... (TAP_HOLD_STATS_BUCKETS counters)
+ *     tap_hold_stats: end
+ *
+ * with the key position as row << 4 | col and the outcome below, in hex.
+ * `sim/build/tracetool stats` decodes a captured console log.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifndef TAP_HOLD_STATS_MAX_KEYS
+#    define TAP_HOLD_STATS_MAX_KEYS 16
+#endif
+
+#define TAP_HOLD_STATS_BUCKETS 12
+
+/** What settled a tap-hold key. */
+enum tap_hold_outcome {
+    // Another key was pressed and Achordion chose hold.
+    TAP_HOLD_CHORD_HOLD,
+    // The Achordion timeout expired.
+    TAP_HOLD_TIMEOUT_HOLD,
+    // The key was held past the tapping term and released with no other key.
+    TAP_HOLD_RELEASE_HOLD,
+    // Another key was pressed and Achordion chose tap.
+    TAP_HOLD_TAP,
+    // Tapped because of a typing streak.
+    TAP_HOLD_STREAK_TAP,
+    // QMK tapped the key before Achordion saw it, within the tapping term.
+    TAP_HOLD_QMK_TAP,
+    // QMK held a key with an `achordion_timeout()` of 0.
+    TAP_HOLD_QMK_HOLD,
+    TAP_HOLD_OUTCOME_COUNT,
+};
+
+typedef struct {
+    uint8_t  pos; // row << 4 | col
+    uint16_t counts[TAP_HOLD_OUTCOME_COUNT][TAP_HOLD_STATS_BUCKETS];
+} tap_hold_stats_key_t;
+
+/** Returns the bucket for a latency of `ms`. */
+uint8_t tap_hold_stats_bucket(uint16_t ms);
+
+/**
+ * Counts a settle decision for the tap-hold key pressed by `press`, taking
+ * the latency from the press to now. Achordion calls this at each decision.
+ */
+void tap_hold_stats_settle(const keyrecord_t *press, uint8_t outcome);
+
+/** Returns the number of keys with a slot, and their histograms. */
+uint8_t                     tap_hold_stats_key_count(void);
+const tap_hold_stats_key_t *tap_hold_stats_keys(void);
+
+/**
+ * Handler for the dump key, which also counts QMK's own decisions. Call it
+ * ahead of `process_achordion()` in `process_record_user()`:
+ *
+ *     if (!process_tap_hold_stats(keycode, record, STATDMP)) {
+ *         return false;
+ *     }
+ */
+bool process_tap_hold_stats(uint16_t keycode, keyrecord_t *record, uint16_t dump_keycode);
+
+/** Prints the histograms. They are left intact. */
+void tap_hold_stats_dump(void);
+
+/** Zeroes the histograms and frees all slots. */
+void tap_hold_stats_clear(void);
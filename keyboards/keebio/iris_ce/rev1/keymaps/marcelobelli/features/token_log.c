@@ -0,0 +1,47 @@
+/**
+ * @file token_log.c
+ * @brief Token Log implementation
+ */
+
+#include "token_log.h"
+
+static token_log_record_t records[TOKEN_LOG_SIZE];
+// Free-running indices, masked on access; head - tail is the fill level.
+static uint8_t  head    = 0;
+static uint8_t  tail    = 0;
+static uint16_t dropped = 0;
+
+_Static_assert(TOKEN_LOG_SIZE <= 128, "TOKEN_LOG_SIZE must fit the 8-bit indices");
+
+static void append(uint8_t id, uint16_t arg) {
+    token_log_record_t *r = &records[head++ & (TOKEN_LOG_SIZE - 1)];
+    r->time               = timer_read();
+    r->arg                = arg;
+    r->id                 = id;
+}
+
+void token_log(uint8_t id, uint16_t arg) {
+    if (!debug_enable) {
+        return;
+    }
+    // Keep a slot for the dropped count.
+    if ((uint8_t)(head - tail) >= TOKEN_LOG_SIZE - 1) {
+        if (dropped < UINT16_MAX) {
+            dropped++;
+        }
+        return;
+    }
+    append(id, arg);
+}
+
+void token_log_task(void) {
+    if (dropped && (uint8_t)(head - tail) < TOKEN_LOG_SIZE) {
+        append(TOKEN_LOG_DROPPED, dropped);
+        dropped = 0;
+    }
+    if (head == tail) {
+        return;
+    }
+    const token_log_record_t *r = &records[tail++ & (TOKEN_LOG_SIZE - 1)];
+    uprintf("token_log: %04X%02X%04X\n", r->time, r->id, r->arg);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file token_log.h
+ * @brief Token Log, debug messages as IDs in a RAM ring buffer.
+ *
+ * Overview
+ * --------
+ *
+ * Debug messages on the tap-hold path are logged as a one-byte message ID and
+ * one 16-bit argument, stamped with the time, into a fixed ring buffer. No
+ * format string is stored or formatted on the board: `token_log_task()` sends
+ * one record per scan to the console as a few hex digits, and the host puts
+ * the text back together from the message table below. Logging a message is a
+ * handful of stores, so debug output can stay on while typing.
+ *
+ * Enable it in rules.mk:
+ *
+ *     TOKEN_LOG_ENABLE = yes
+ *
+ * and optionally size the buffer in config.h (a power of two):
+ *
+ *     #define TOKEN_LOG_SIZE 128
+ *
+ * As with `dprintf()`, messages are only logged while `debug_enable` is on.
+ * When the buffer is full, new messages are dropped and counted, and the
+ * count is sent as a `TOKEN_LOG_DROPPED` record once there is room.
+ *
+ * Without `TOKEN_LOG_ENABLE`, `token_log()` falls back to `dprintf()` with the
+ * message's format string, as the code did before.
+ *
+ * Messages
+ * --------
+ *
+ * `TOKEN_LOG_MESSAGES` is the one list of messages: the firmware takes the
+ * IDs from it and `sim/build/tracetool log` the format strings, so the two
+ * can't drift apart. Each format takes at most one 16-bit argument. Append new
+ * messages at the end, so that older logs still decode.
+ *
+ * Dump format
+ * -----------
+ *
+ *     token_log: TTTTIIAAAA
+ *
+ * with the low 16 bits of the time, the message ID and the argument in hex.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// clang-format off
+#define TOKEN_LOG_MESSAGES(X)                                                                           \
+    X(TOKEN_LOG_DROPPED,                   "token_log: %u messages dropped.")                           \
+    X(ACHORDION_LOG_EAGER_HOLD,            "Achordion: Settled eager mod as hold.")                     \
+    X(ACHORDION_LOG_HOLD_PRESS,            "Achordion: Plumbing hold press.")                           \
+    X(ACHORDION_LOG_TAP_PRESS,             "Achordion: Plumbing tap press.")                            \
+    X(ACHORDION_LOG_TAP_RELEASE,           "Achordion: Plumbing tap release.")                          \
+    X(ACHORDION_LOG_KEY_PRESSED,           "Achordion: Key 0x%04X pressed.")                            \
+    X(ACHORDION_LOG_KEY_PRESSED_EAGER,     "Achordion: Key 0x%04X pressed. Set eager mods.")            \
+    X(ACHORDION_LOG_RELEASED_EAGER,        "Achordion: Key released. Clearing eager mods.")             \
+    X(ACHORDION_LOG_RELEASED_HOLD,         "Achordion: Key released. Plumbing hold release.")           \
+    X(ACHORDION_LOG_RELEASED_HOLD_PRESS,   "Achordion: Key released. Plumbing hold press and release.") \
+    X(ACHORDION_LOG_RELEASED,              "Achordion: Key released.")                                  \
+    X(ACHORDION_LOG_STREAK_TAP,            "Achordion: Key 0x%04X pressed in a streak. Tapped.")        \
+    X(ACHORDION_LOG_SPECULATIVE_TAP,       "Achordion: Key 0x%04X pressed. Sent tap ahead.")            \
+    X(ACHORDION_LOG_TAKE_BACK_TAP,         "Achordion: Taking back tap with Backspace.")
+// clang-format on
+
+#define TOKEN_LOG_ID(id, format) id,
+#define TOKEN_LOG_FORMAT(id, format) format,
+
+enum token_log_id { TOKEN_LOG_MESSAGES(TOKEN_LOG_ID) TOKEN_LOG_MESSAGE_COUNT };
+
+#ifdef TOKEN_LOG_ENABLE
+
+#    ifndef TOKEN_LOG_SIZE
+#        define TOKEN_LOG_SIZE 64
+#    endif
+
+_Static_assert((TOKEN_LOG_SIZE & (TOKEN_LOG_SIZE - 1)) == 0, "TOKEN_LOG_SIZE must be a power of two");
+
+typedef struct {
+    uint16_t time; // Low 16 bits of the time logged.
+    uint16_t arg;
+    uint8_t  id;
+} token_log_record_t;
+
+/** Logs message `id` with `arg`, if `debug_enable` is on. */
+void token_log(uint8_t id, uint16_t arg);
+
+/**
+ * Sends the oldest record to the console. Call from `matrix_scan_user()`, so
+ * the console cost is spread over the scans after the logged event.
+ */
+void token_log_task(void);
+
+#else
+
+static inline const char *token_log_format(uint8_t id) {
+    static const char *const formats[] = {TOKEN_LOG_MESSAGES(TOKEN_LOG_FORMAT)};
+    return formats[id];
+}
+
+#    define token_log(id, arg)                    \
+        do {                                      \
+            dprintf(token_log_format(id), (arg)); \
+            dprintf("\n");                        \
+        } while (0)
+
+#endif // TOKEN_LOG_ENABLE
@@ -13,7 +13,21 @@
 #include QMK_KEYBOARD_H
 
 #include "features/achordion.h"
+#include "features/idle_governor.h"
 #include "features/layer_lock.h"
+#include "features/macro_queue.h"
+#include "features/report_diff.h"
+#include "features/scan_profiler.h"
+#include "macro_reports.h"
+#ifdef KEY_RECORDER_ENABLE
+#    include "features/key_recorder.h"
+#endif
+#ifdef TAP_HOLD_STATS_ENABLE
+#    include "features/tap_hold_stats.h"
+#endif
+#ifdef TOKEN_LOG_ENABLE
+#    include "features/token_log.h"
+#endif
 
 #define LOCK_SCREEN LGUI(LCTL(KC_Q))
 #define UNDO LCMD(KC_Z)
@@ -27,6 +41,9 @@ enum custom_keycodes {
     DOUBLE_EQUAL = SAFE_RANGE,
     NOT_EQUAL,
     LLOCK,
+    RECDUMP,
+    PROFDMP,
+    STATDMP,
 };
 
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
@@ -60,7 +77,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
     [_LOWER] = LAYOUT(
         //
         // ┌─────────┬─────────┬─────────┬─────────┬─────────┬─────────┐                        ┌─────────┬─────────┬─────────┬─────────┬─────────┬─────────┐
-        // ├  BOOT   ┼ EE CLR  ┼         ┼         ┼         ┼         ┤                        ├         ┼         ┼         ┼         ┼         ┼         ┤
+        // ├  BOOT   ┼ EE CLR  ┼         ┼ HLD DMP ┼ PRF DMP ┼ REC DMP ┤                        ├         ┼         ┼         ┼         ┼         ┼         ┤
         // ├─────────┼─────────┼─────────┼─────────┼─────────┼─────────┤                        ├─────────┼─────────┼─────────┼─────────┼─────────┼─────────┤
         // ├   TAB   ┼         ┼         ┼         ┼         ┼         ┤                        ├         ┼         ┼         ┼         ┼  UNDO   ┼  REDO   ┤
         // ├─────────┼─────────┼─────────┼─────────┼─────────┼─────────┤                        ├─────────┼─────────┼─────────┼─────────┼─────────┼─────────┤
@@ -71,7 +88,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         //                                    ├         ┼         ┼         ┤              ├   ENT   ┼         ┼   DEL   ┤
         //                                    └─────────┴─────────┴─────────┘              └─────────┴─────────┴─────────┘
         //
-        QK_BOOT, EE_CLR, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO,
+        QK_BOOT, EE_CLR, KC_NO, STATDMP, PROFDMP, RECDUMP, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO,
         //
         KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, UNDO, REDO,
         //
@@ -109,23 +126,23 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         //
         )};
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
-    if (!process_achordion(keycode, record)) {
-        return false;
-    }
-    if (!process_layer_lock(keycode, record, LLOCK)) {
-        return false;
-    }
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+#ifdef KEY_RECORDER_ENABLE
+    key_recorder_event(record);
+#endif
+    return REPORT_DIFF_BATCH(pre_process_achordion(keycode, record));
+}
 
+static bool process_macros(uint16_t keycode, keyrecord_t *record) {
     switch (keycode) {
         case DOUBLE_EQUAL:
             if (record->event.pressed) {
-                SEND_STRING("==");
+                macro_queue_send(macro_double_equal);
             }
             break;
         case NOT_EQUAL:
             if (record->event.pressed) {
-                SEND_STRING("!=");
+                macro_queue_send(macro_not_equal);
             }
             break;
     }
@@ -133,14 +150,71 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    SCAN_PROFILE_SCOPE(SCAN_PROFILE_PROCESS_RECORD_USER);
+    if (IS_KEYEVENT(record->event)) {
+        idle_governor_activity();
+    }
+#ifdef KEY_RECORDER_ENABLE
+    if (!process_key_recorder(keycode, record, RECDUMP)) {
+        return false;
+    }
+#endif
+#ifdef SCAN_PROFILER_ENABLE
+    if (!process_scan_profiler(keycode, record, PROFDMP)) {
+        return false;
+    }
+#endif
+#ifdef TAP_HOLD_STATS_ENABLE
+    if (!process_tap_hold_stats(keycode, record, STATDMP)) {
+        return false;
+    }
+#endif
+    process_macro_queue(keycode, record);
+    if (!SCAN_PROFILE(SCAN_PROFILE_ACHORDION, REPORT_DIFF_BATCH(process_achordion(keycode, record)))) {
+        return false;
+    }
+    if (!SCAN_PROFILE(SCAN_PROFILE_LAYER_LOCK, process_layer_lock(keycode, record, LLOCK))) {
+        return false;
+    }
+
+    return SCAN_PROFILE(SCAN_PROFILE_MACROS, process_macros(keycode, record));
+}
+
+layer_state_t layer_state_set_user(layer_state_t state) {
+    return layer_lock_layer_state_set(state);
+}
+
 void matrix_scan_user(void) {
-    achordion_task();
+#ifdef SCAN_PROFILER_ENABLE
+    scan_profiler_task();
+#endif
+#ifdef TOKEN_LOG_ENABLE
+    SCAN_PROFILE_SCOPE(SCAN_PROFILE_TOKEN_LOG);
+    token_log_task();
+#endif
 }
 
-bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
-    HSV     hsv           = {213, 255, rgblight_get_val()}; // MANGENTA
-    uint8_t current_layer = get_highest_layer(layer_state | default_layer_state);
-    switch (current_layer) {
+void housekeeping_task_user(void) {
+    idle_governor_task();
+    report_diff_task();
+}
+
+void keyboard_post_init_user(void) {
+    idle_governor_init();
+}
+
+// Indicator color of each LED for the highest active layer. Rebuilt only
+// when the layer or the brightness changes; each call then copies its chunk.
+static RGB     indicator_colors[RGB_MATRIX_LED_COUNT];
+// LEDs under a key. The others keep the effect's color.
+static bool    indicator_keyed[RGB_MATRIX_LED_COUNT];
+static uint8_t indicator_layer = UINT8_MAX;
+static uint8_t indicator_val;
+
+static void build_indicator_colors(uint8_t layer, uint8_t val) {
+    HSV hsv = {213, 255, val}; // MANGENTA
+    switch (layer) {
         case _RAISE:
             hsv.h = 11; // CORAL
             break;
@@ -149,30 +223,54 @@ bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
             break;
         default:
             rgb_matrix_sethsv(hsv.h, hsv.s, hsv.v);
-            return false;
+            return;
     }
 
-    HSV boot_hsv   = {0, 255, rgb_matrix_get_val()};
-    HSV ee_clr_hsv = {0, 0, rgb_matrix_get_val()};
-    RGB layer_rgb  = hsv_to_rgb(hsv);
+    const RGB boot_rgb   = hsv_to_rgb((HSV){0, 255, val});
+    const RGB ee_clr_rgb = hsv_to_rgb((HSV){0, 0, val});
+    const RGB layer_rgb  = hsv_to_rgb(hsv);
     for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
         for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            uint8_t  index   = g_led_config.matrix_co[row][col];
-            uint16_t keycode = keymap_key_to_keycode(current_layer, (keypos_t){col, row});
+            const uint8_t index = g_led_config.matrix_co[row][col];
+            if (index >= RGB_MATRIX_LED_COUNT) {
+                continue;
+            }
+            const uint16_t keycode = keymap_key_to_keycode(layer, (keypos_t){col, row});
 
+            indicator_keyed[index] = true;
             if (keycode == QK_BOOT) {
-                RGB rgb = hsv_to_rgb(boot_hsv);
-                rgb_matrix_set_color(index, rgb.r, rgb.g, rgb.b);
+                indicator_colors[index] = boot_rgb;
             } else if (keycode == EE_CLR) {
-                RGB rgb = hsv_to_rgb(ee_clr_hsv);
-                rgb_matrix_set_color(index, rgb.r, rgb.g, rgb.b);
+                indicator_colors[index] = ee_clr_rgb;
             } else if (keycode <= KC_NO) {
-                rgb_matrix_set_color(index, HSV_BLACK);
+                indicator_colors[index] = (RGB){RGB_BLACK};
             } else {
-                rgb_matrix_set_color(index, layer_rgb.r, layer_rgb.g, layer_rgb.b);
+                indicator_colors[index] = layer_rgb;
             }
         }
     }
+}
+
+bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    SCAN_PROFILE_SCOPE(SCAN_PROFILE_RGB_INDICATORS);
+    // The layer can change without input, e.g. when Layer Lock times out,
+    // so it is checked on every frame. The brightness only changes on input,
+    // so idle frames skip that check.
+    const uint8_t current_layer = get_highest_layer(layer_state | default_layer_state);
+    if (current_layer != indicator_layer || (!idle_governor_is_idle() && rgb_matrix_get_val() != indicator_val)) {
+        indicator_layer = current_layer;
+        indicator_val   = rgb_matrix_get_val();
+        build_indicator_colors(indicator_layer, indicator_val);
+    }
+    if (indicator_layer != _LOWER && indicator_layer != _RAISE) {
+        return false;
+    }
+
+    for (uint8_t i = led_min; i < led_max; i++) {
+        if (indicator_keyed[i]) {
+            rgb_matrix_set_color(i, indicator_colors[i].r, indicator_colors[i].g, indicator_colors[i].b);
+        }
+    }
 
     return false;
 }
@@ -190,6 +288,10 @@ bool achordion_chord(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, ui
     return achordion_opposite_hands(tap_hold_record, other_record);
 }
 
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return achordion_overlap_hold(keycode, record) ? 0 : TAPPING_TERM;
+}
+
 uint16_t achordion_timeout(uint16_t tap_hold_keycode) {
     switch (tap_hold_keycode) {
         case HYPR_T(KC_BSPC):
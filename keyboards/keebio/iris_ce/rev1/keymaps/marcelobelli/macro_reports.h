@@ -0,0 +1,25 @@
+// Generated by sim/macrogen from macro_strings.h, do not edit.
+// Each report is {mods, keycode}.
+
+#pragma once
+
+#include "features/macro_queue.h"
+
+// "=="
+static const macro_report_t macro_double_equal[] PROGMEM = {
+    {0x00, 0x2E},
+    {0x00, 0x00},
+    {0x00, 0x2E},
+    {0x00, 0x00},
+    {0x00, MACRO_END},
+};
+
+// "!="
+static const macro_report_t macro_not_equal[] PROGMEM = {
+    {0x02, 0x00},
+    {0x02, 0x1E},
+    {0x00, 0x00},
+    {0x00, 0x2E},
+    {0x00, 0x00},
+    {0x00, MACRO_END},
+};
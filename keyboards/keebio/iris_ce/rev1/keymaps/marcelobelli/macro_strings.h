@@ -0,0 +1,12 @@
+// String macros, compiled into report sequences in macro_reports.h by
+// sim/macrogen: `make -C sim` regenerates it after a change here. Each entry
+// is X(name, string), and keymap.c sends it with
+// `macro_queue_send(macro_<name>)`.
+
+#pragma once
+
+// clang-format off
+#define MACRO_STRINGS(X)         \
+    X(double_equal, "==")        \
+    X(not_equal,    "!=")
+// clang-format on
@@ -1,5 +1,40 @@
 SRC += features/achordion.c
 SRC += features/layer_lock.c
+SRC += features/idle_governor.c
+SRC += features/macro_queue.c
+SRC += features/report_diff.c
 
+# Keep recent key events in RAM for dumping with RECDUMP, see features/key_recorder.h.
+KEY_RECORDER_ENABLE ?= no
+ifeq ($(strip $(KEY_RECORDER_ENABLE)), yes)
+    SRC += features/key_recorder.c
+    OPT_DEFS += -DKEY_RECORDER_ENABLE
+endif
+
+# Time the keymap's hooks per stage, dump with PROFDMP, see features/scan_profiler.h.
+SCAN_PROFILER_ENABLE ?= no
+ifeq ($(strip $(SCAN_PROFILER_ENABLE)), yes)
+    SRC += features/scan_profiler.c
+    OPT_DEFS += -DSCAN_PROFILER_ENABLE
+endif
+
+# Count Achordion settle latencies per key and outcome, dump with STATDMP, see features/tap_hold_stats.h.
+TAP_HOLD_STATS_ENABLE ?= no
+ifeq ($(strip $(TAP_HOLD_STATS_ENABLE)), yes)
+    SRC += features/tap_hold_stats.c
+    OPT_DEFS += -DTAP_HOLD_STATS_ENABLE
+endif
+
+# Log Achordion's debug messages as IDs and decode them on the host, see features/token_log.h.
+TOKEN_LOG_ENABLE ?= no
+ifeq ($(strip $(TOKEN_LOG_ENABLE)), yes)
+    SRC += features/token_log.c
+    OPT_DEFS += -DTOKEN_LOG_ENABLE
+endif
+
+# Achordion's timeouts run as deferred callbacks instead of polling every scan.
+DEFERRED_EXEC_ENABLE = yes
 CAPS_WORD_ENABLE = yes
+# BREATHING_TABLE, the default effect, see rgb_matrix_user.inc.
+RGB_MATRIX_CUSTOM_USER = yes
 
@@ -0,0 +1,209 @@
+// Host simulator: synthetic typing benchmark.
+//
+// Generates a random but reproducible stream of overlapping presses and
+// releases over the base layer (letters, home row mods, thumb layer-taps),
+// feeds it through process_record_user()/matrix_scan_user() on the virtual
+// clock, and reports host throughput.
+//
+//     ./build/bench [-n events] [-s seed] [-i scan_interval_ms] [-g gap_ms] [-r] [-v] [-w out.ktr]
+//
+//   -g  stop typing for gap_ms after every 1000 events, to exercise the Idle
+//       Governor (see features/idle_governor.h)
+//   -r  disable the RGB Matrix task
+//   -v  print every report that reaches the host
+//   -w  also write the generated events as a .ktr capture
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "trace_bin.h"
+#include "features/idle_governor.h"
+
+#define MAX_HELD 4
+
+typedef struct {
+    keypos_t key;
+    uint32_t release_time;
+} held_key_t;
+
+static uint32_t rng_state;
+
+static uint32_t rng_next(void) {
+    // xorshift32, so runs are identical across hosts for a given seed.
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32_t rng_range(uint32_t lo, uint32_t hi) {
+    return lo + rng_next() % (hi - lo + 1);
+}
+
+static void print_report(const sim_report_t *sent, void *ctx) {
+    const report_keyboard_t *r = &sent->report;
+    printf("%8u mods=%02X keys=%02X %02X %02X %02X %02X %02X\n", sent->time, r->mods, r->keys[0], r->keys[1], r->keys[2], r->keys[3], r->keys[4], r->keys[5]);
+}
+
+static trace_bin_writer_t capture;
+static bool               capturing;
+
+// Feeds one generated event to the simulator, recording it if capturing.
+static void key_event(keypos_t key, bool pressed) {
+    if (capturing) {
+        const trace_event_t event    = {.time = sim_now(), .key = key, .pressed = pressed};
+        const keyevent_t    keyevent = {.key = key, .pressed = pressed, .type = KEY_EVENT};
+        if (!trace_bin_write(&capture, &event, get_event_keycode(keyevent, false), layer_state)) {
+            perror("capture");
+            exit(1);
+        }
+    }
+    sim_key(key, pressed);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Collects the base layer keys that a typist would hit in running text.
+static uint8_t collect_keys(keypos_t *keys, uint8_t max) {
+    uint8_t count = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            const keypos_t pos     = {.col = col, .row = row};
+            uint16_t       keycode = keymap_key_to_keycode(0, pos);
+            if (IS_QK_MOD_TAP(keycode)) {
+                keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+            } else if (IS_QK_LAYER_TAP(keycode)) {
+                keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+            }
+            const bool typed = (keycode >= KC_A && keycode <= KC_Z) || keycode == KC_SPACE || keycode == KC_BACKSPACE || keycode == KC_COMMA || keycode == KC_DOT || keycode == KC_SEMICOLON || keycode == KC_QUOTE;
+            if (typed && count < max) {
+                keys[count++] = pos;
+            }
+        }
+    }
+    return count;
+}
+
+int main(int argc, char **argv) {
+    uint32_t events   = 1000000;
+    uint32_t seed     = 1;
+    uint16_t interval = 1;
+    uint32_t gap      = 0;
+    bool     rgb      = true;
+    bool     verbose  = false;
+    char    *out      = NULL;
+    int      opt;
+    while ((opt = getopt(argc, argv, "n:s:i:g:rvw:")) != -1) {
+        switch (opt) {
+            case 'n':
+                events = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            case 'i':
+                interval = strtoul(optarg, NULL, 0);
+                break;
+            case 'g':
+                gap = strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                rgb = false;
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            case 'w':
+                out = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n events] [-s seed] [-i scan_interval_ms] [-g gap_ms] [-r] [-v] [-w out.ktr]\n", argv[0]);
+                return 2;
+        }
+    }
+    rng_state = seed ? seed : 1;
+
+    sim_init();
+    sim_config.scan_interval = interval;
+    sim_config.rgb_enabled   = rgb;
+    if (verbose) {
+        sim_set_report_hook(print_report, NULL);
+    }
+    if (out) {
+        capturing = trace_bin_writer_open(&capture, out, 0);
+        if (!capturing) {
+            return 1;
+        }
+    }
+
+    keypos_t      keys[MATRIX_ROWS * MATRIX_COLS];
+    const uint8_t key_count = collect_keys(keys, sizeof(keys) / sizeof(keys[0]));
+    held_key_t    held[MAX_HELD];
+    uint8_t       held_count = 0;
+    uint32_t      next_press = 0;
+    uint32_t      presses    = 0;
+
+    const double start = now_seconds();
+    while (sim_stats.key_events < events) {
+        // Release held keys that are due before the next press, in order.
+        for (;;) {
+            int8_t due = -1;
+            for (uint8_t i = 0; i < held_count; i++) {
+                if (held[i].release_time <= next_press && (due < 0 || held[i].release_time < held[due].release_time)) {
+                    due = i;
+                }
+            }
+            if (due < 0) {
+                break;
+            }
+            sim_advance_to(held[due].release_time);
+            key_event(held[due].key, false);
+            held[due] = held[--held_count];
+        }
+
+        sim_advance_to(next_press);
+        if (held_count < MAX_HELD) {
+            keypos_t key;
+            bool     busy;
+            do {
+                key  = keys[rng_next() % key_count];
+                busy = sim_key_is_pressed(key);
+            } while (busy);
+            key_event(key, true);
+            held[held_count++] = (held_key_t){.key = key, .release_time = sim_now() + rng_range(30, 160)};
+        }
+        // Mostly typing-speed gaps, with the occasional pause.
+        next_press = sim_now() + (rng_next() % 16 ? rng_range(15, 180) : rng_range(300, 1500));
+        if (gap && ++presses % 1000 == 0) {
+            next_press += gap;
+        }
+    }
+    for (uint8_t i = 0; i < held_count; i++) {
+        key_event(held[i].key, false);
+    }
+    sim_quiesce(2000);
+    const double elapsed = now_seconds() - start;
+    if (capturing && !trace_bin_writer_close(&capture)) {
+        perror(out);
+        return 1;
+    }
+
+    printf("key events:     %u\n", sim_stats.key_events);
+    printf("virtual time:   %.1f s\n", sim_now() / 1000.0);
+    printf("matrix scans:   %u\n", sim_stats.scans);
+    printf("records:        %u\n", sim_stats.records);
+    printf("reports:        %u sent / %u requested\n", sim_stats.reports_sent, sim_stats.reports_requested);
+    printf("rgb frames:     %u\n", sim_stats.rgb_frames);
+    printf("led writes:     %u\n", sim_stats.led_writes);
+    printf("idle periods:   %u (%.1f s)\n", idle_governor_stats.idle_entries, idle_governor_stats.idle_time / 1000.0);
+    printf("split syncs:    %u\n", sim_stats.split_transactions);
+    printf("host time:      %.3f s\n", elapsed);
+    printf("events/sec:     %.0f\n", sim_stats.key_events / elapsed);
+    printf("ns/event:       %.1f (including %.1f scans/event)\n", elapsed * 1e9 / sim_stats.key_events, (double)sim_stats.scans / sim_stats.key_events);
+    return 0;
+}
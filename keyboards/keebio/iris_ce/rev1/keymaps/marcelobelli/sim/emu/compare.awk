@@ -0,0 +1,14 @@
+# Host simulator, emulated target: compares two emu_bench tables.
+#
+#     awk -v tolerance=5 -f emu/compare.awk baseline.txt bench.txt
+#
+# Fails if a stage's mean in the second table is more than `tolerance`
+# percent above the first's.
+
+FNR == 1 || $1 == "done" { next }
+NR == FNR { baseline[$1] = $4; next }
+($1 in baseline) && $4 > baseline[$1] * (1 + tolerance / 100) {
+    printf "emu_bench: %s mean %d, baseline %d\n", $1, $4, baseline[$1]
+    failed = 1
+}
+END { exit failed }
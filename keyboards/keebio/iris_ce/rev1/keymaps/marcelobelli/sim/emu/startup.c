@@ -0,0 +1,42 @@
+// Host simulator, emulated target: bare-metal startup for emu_bench.
+//
+// Vector table, .data/.bss setup and a newlib _write() that prints on the
+// PL011 UART at the RP2040's UART0 address. No clocks or peripherals are set
+// up; the emulated platform in cortex_m0.repl has none to set up.
+
+#include <stdint.h>
+#include <string.h>
+
+#define UART0_DR (*(volatile uint32_t *)0x40034000)
+
+extern uint32_t _estack, _sidata, _sdata, _edata, _sbss, _ebss;
+
+int main(int argc, char **argv);
+
+void Reset_Handler(void) {
+    memcpy(&_sdata, &_sidata, (uintptr_t)&_edata - (uintptr_t)&_sdata);
+    memset(&_sbss, 0, (uintptr_t)&_ebss - (uintptr_t)&_sbss);
+    main(0, 0);
+    for (;;) {
+        __asm__ volatile("wfi");
+    }
+}
+
+static void Default_Handler(void) {
+    for (;;) {
+    }
+}
+
+__attribute__((section(".vectors"), used)) static void *const vectors[16] = {
+    &_estack,
+    Reset_Handler,
+    Default_Handler, // NMI
+    Default_Handler, // HardFault
+};
+
+int _write(int fd, const char *buf, int len) {
+    for (int i = 0; i < len; i++) {
+        UART0_DR = buf[i];
+    }
+    return len;
+}
@@ -0,0 +1,208 @@
+// Host simulator: per-stage cost of the keymap code on a Cortex-M0+.
+//
+// Replays a .ktr script through the simulator one scan at a time and times
+// every matrix scan and key event, and, through the linker's --wrap, every
+// call of process_record_user(), matrix_scan_user() and
+// rgb_matrix_indicators_advanced_user().
+//
+// Cross-compiled (`make emu-bench`), it runs bare metal on an emulated
+// Cortex-M0+ under Renode (see emu/) and counts cycles with SysTick. That
+// path is unverified: it has not been run, and the image holds the keymap on
+// the mocked core, not the QMK firmware. The
+// emulator loads the script into RAM at EMU_SCRIPT_ADDR and its size at
+// EMU_SCRIPT_SIZE_ADDR, and the table comes out of the UART. Built for the
+// host, the same driver reads the script from a file and counts nanoseconds,
+// which only keeps it compiling and is no guide to what the RP2040 pays:
+//
+//     ./build/emu_bench script.ktr
+
+#include <string.h>
+#include "sim.h"
+#include "trace_bin.h"
+
+#ifdef __arm__
+// Must agree with emu/link.ld and emu/bench.resc.
+#    define EMU_SCRIPT_ADDR 0x20020000
+#    define EMU_SCRIPT_SIZE_ADDR 0x2001FFFC
+#    define UNIT "cycles"
+
+#    define SYST_CSR (*(volatile uint32_t *)0xE000E010)
+#    define SYST_RVR (*(volatile uint32_t *)0xE000E014)
+#    define SYST_CVR (*(volatile uint32_t *)0xE000E018)
+
+// SysTick counts down from 2^24 - 1 at the core clock, so intervals are
+// exact up to 16.7M cycles.
+static void cycles_init(void) {
+    SYST_RVR = 0xFFFFFF;
+    SYST_CVR = 0;
+    SYST_CSR = 0x5; // Core clock, no interrupt, enabled.
+}
+
+static uint32_t cycles(void) {
+    return 0xFFFFFF - SYST_CVR;
+}
+
+static uint32_t cycles_since(uint32_t start) {
+    return (cycles() - start) & 0xFFFFFF;
+}
+#else
+#    include <time.h>
+#    define UNIT "ns"
+
+static void cycles_init(void) {}
+
+static uint32_t cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t cycles_since(uint32_t start) {
+    return cycles() - start;
+}
+#endif
+
+enum {
+    STAGE_SCAN,
+    STAGE_EVENT,
+    STAGE_PROCESS_RECORD_USER,
+    STAGE_MATRIX_SCAN_USER,
+    STAGE_RGB_INDICATORS,
+    STAGE_COUNT,
+};
+
+static const char *const stage_names[STAGE_COUNT] = {
+    [STAGE_SCAN]                = "scan",
+    [STAGE_EVENT]               = "event",
+    [STAGE_PROCESS_RECORD_USER] = "process_record_user",
+    [STAGE_MATRIX_SCAN_USER]    = "matrix_scan_user",
+    [STAGE_RGB_INDICATORS]      = "rgb_indicators",
+};
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} stage_t;
+
+static stage_t  stages[STAGE_COUNT];
+static uint32_t overhead;
+
+static void stage_add(uint8_t stage, uint32_t start) {
+    const uint32_t raw     = cycles_since(start);
+    const uint32_t elapsed = raw > overhead ? raw - overhead : 0;
+    stage_t       *s       = &stages[stage];
+    if (s->count == 0 || elapsed < s->min) {
+        s->min = elapsed;
+    }
+    if (elapsed > s->max) {
+        s->max = elapsed;
+    }
+    s->total += elapsed;
+    s->count++;
+}
+
+// The cost of timing an empty interval, taken off every sample.
+static void calibrate(void) {
+    overhead = UINT32_MAX;
+    for (uint8_t i = 0; i < 100; i++) {
+        const uint32_t start   = cycles();
+        const uint32_t elapsed = cycles_since(start);
+        if (elapsed < overhead) {
+            overhead = elapsed;
+        }
+    }
+}
+
+bool __real_process_record_user(uint16_t keycode, keyrecord_t *record);
+void __real_matrix_scan_user(void);
+bool __real_rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
+
+bool __wrap_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    const uint32_t start  = cycles();
+    const bool     result = __real_process_record_user(keycode, record);
+    stage_add(STAGE_PROCESS_RECORD_USER, start);
+    return result;
+}
+
+void __wrap_matrix_scan_user(void) {
+    const uint32_t start = cycles();
+    __real_matrix_scan_user();
+    stage_add(STAGE_MATRIX_SCAN_USER, start);
+}
+
+bool __wrap_rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    const uint32_t start  = cycles();
+    const bool     result = __real_rgb_matrix_indicators_advanced_user(led_min, led_max);
+    stage_add(STAGE_RGB_INDICATORS, start);
+    return result;
+}
+
+// Replays the script one scan at a time. The header is checked by the caller.
+static void run(const trace_bin_record_t *records, size_t count) {
+    sim_init();
+    uint32_t time = 0;
+    for (size_t i = 0; i < count; i++) {
+        time += records[i].delta;
+        while ((int32_t)(time - sim_now()) > 0) {
+            const uint32_t start = cycles();
+            sim_advance(1);
+            stage_add(STAGE_SCAN, start);
+        }
+        if (records[i].flags & TRACE_BIN_GAP) {
+            continue;
+        }
+        const keypos_t key   = {.col = records[i].pos & 0xF, .row = records[i].pos >> 4};
+        const uint32_t start = cycles();
+        sim_key(key, records[i].flags & TRACE_BIN_PRESSED);
+        stage_add(STAGE_EVENT, start);
+    }
+}
+
+static bool check_header(const trace_bin_header_t *header, size_t size) {
+    if (size < sizeof(*header) || memcmp(header->magic, TRACE_BIN_MAGIC, 4) != 0 || header->version != TRACE_BIN_VERSION || header->record_size != sizeof(trace_bin_record_t)) {
+        printf("emu_bench: no version %d .ktr script\n", TRACE_BIN_VERSION);
+        return false;
+    }
+    if (header->matrix_rows != MATRIX_ROWS || header->matrix_cols != MATRIX_COLS) {
+        printf("emu_bench: script is for a %ux%u matrix\n", header->matrix_rows, header->matrix_cols);
+        return false;
+    }
+    return true;
+}
+
+static void print_stages(void) {
+    printf("%-20s %8s %8s %8s %8s  (%s)\n", "stage", "count", "min", "mean", "max", UNIT);
+    for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+        const stage_t *s = &stages[i];
+        printf("%-20s %8lu %8lu %8lu %8lu\n", stage_names[i], (unsigned long)s->count, (unsigned long)s->min, (unsigned long)(s->count ? s->total / s->count : 0), (unsigned long)s->max);
+    }
+}
+
+int main(int argc, char **argv) {
+    cycles_init();
+    calibrate();
+#ifdef __arm__
+    const size_t              size   = *(volatile const uint32_t *)EMU_SCRIPT_SIZE_ADDR;
+    const trace_bin_header_t *header = (const trace_bin_header_t *)EMU_SCRIPT_ADDR;
+#else
+    trace_bin_t bin;
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s script.ktr\n", argv[0]);
+        return 2;
+    }
+    if (!trace_bin_open(argv[1], &bin)) {
+        return 1;
+    }
+    const size_t              size   = bin.map_size;
+    const trace_bin_header_t *header = bin.header;
+#endif
+    if (!check_header(header, size)) {
+        return 1;
+    }
+    run((const trace_bin_record_t *)(header + 1), (size - sizeof(*header)) / sizeof(trace_bin_record_t));
+    print_stages();
+    printf("done\n");
+    return 0;
+}
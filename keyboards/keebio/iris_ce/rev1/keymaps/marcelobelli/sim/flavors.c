@@ -0,0 +1,205 @@
+// Host simulator: Achordion against QMK's core tap-hold flavors.
+//
+// Replays the same traces under the keymap as built (Achordion on top of the
+// config.h settings) and under core-only flavors with Achordion switched off,
+// then diffs every press: how it settled (tap, hold, or a plain key) and how
+// long it took to act.
+//
+//     ./build/flavors [-a] [-q] traces...
+//
+//   -a  list every press, not only the ones where a flavor disagrees
+//   -q  print only the summary
+//
+// Flavors:
+//
+//   achordion    keymap.c as built
+//   permissive   PERMISSIVE_HOLD
+//   hold-other   HOLD_ON_OTHER_KEY_PRESS
+//   chordal      CHORDAL_HOLD + PERMISSIVE_HOLD
+//   chordal-hold CHORDAL_HOLD + HOLD_ON_OTHER_KEY_PRESS
+//
+// Achordion is switched off by overriding achordion_timeout() to return 0 for
+// every key, which makes it pass tap-hold keys straight through. keymap.c's
+// version is renamed to __real_achordion_timeout() at build time.
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "press_log.h"
+#include "trace_bin.h"
+
+#define IDLE_AFTER_TRACE 2000
+
+typedef struct {
+    const char *name;
+    bool        achordion;
+    bool        permissive_hold;
+    bool        hold_on_other_key_press;
+    bool        chordal_hold;
+} flavor_t;
+
+static const flavor_t flavors[] = {
+    {.name = "achordion", .achordion = true},
+    {.name = "permissive", .permissive_hold = true},
+    {.name = "hold-other", .hold_on_other_key_press = true},
+    {.name = "chordal", .chordal_hold = true, .permissive_hold = true},
+    {.name = "chordal-hold", .chordal_hold = true, .hold_on_other_key_press = true},
+};
+#define FLAVOR_COUNT (sizeof(flavors) / sizeof(flavors[0]))
+
+static bool achordion_enabled;
+
+uint16_t __real_achordion_timeout(uint16_t tap_hold_keycode);
+
+uint16_t achordion_timeout(uint16_t tap_hold_keycode) {
+    return achordion_enabled ? __real_achordion_timeout(tap_hold_keycode) : 0;
+}
+
+// keymap.c's, renamed along with achordion_timeout(). With Achordion off, its
+// overlap rule is off too.
+uint16_t __real_get_tapping_term(uint16_t keycode, keyrecord_t *record);
+
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return __real_get_tapping_term(keycode, record);
+}
+
+// Replays all traces under `flavor`, noting where each trace's presses start.
+static void run_flavor(const flavor_t *flavor, const trace_t *traces, int trace_count, press_log_t *log, size_t *trace_begin) {
+    sim_init();
+    sim_config.rgb_enabled = false;
+    if (!flavor->achordion) {
+        sim_config.permissive_hold         = flavor->permissive_hold;
+        sim_config.hold_on_other_key_press = flavor->hold_on_other_key_press;
+        sim_config.chordal_hold            = flavor->chordal_hold;
+    }
+    achordion_enabled = flavor->achordion;
+    press_log_attach(log);
+    for (int t = 0; t < trace_count; t++) {
+        trace_begin[t] = log->count;
+        press_log_start_trace(log);
+        const uint32_t start = sim_now();
+        for (size_t i = 0; i < traces[t].count; i++) {
+            sim_advance_to(start + traces[t].events[i].time);
+            press_log_key(log, &traces[t].events[i]);
+        }
+        sim_quiesce(IDLE_AFTER_TRACE);
+    }
+    trace_begin[trace_count] = log->count;
+}
+
+static const char *outcome(const press_t *press) {
+    if (!press->acted) {
+        return "-";
+    }
+    if (!press->tap_hold) {
+        return "key";
+    }
+    return press->held ? "hold" : "tap";
+}
+
+static bool same_outcome(const press_t *a, const press_t *b) {
+    return a->acted == b->acted && a->tap_hold == b->tap_hold && a->held == b->held;
+}
+
+static void print_press(press_log_t *logs, size_t i) {
+    static const char *const intents[] = {"", "tap", "hold"};
+    const press_t           *base      = &logs[0].presses[i];
+    printf("  %5u  %-7s %-4s", base->line, trace_key_name(base->key), intents[base->intent]);
+    for (size_t f = 0; f < FLAVOR_COUNT; f++) {
+        const press_t *press = &logs[f].presses[i];
+        printf(" | %-4s %5d %c", outcome(press), press_latency(press), press_is_misfire(press) ? '!' : ' ');
+    }
+    printf("\n");
+}
+
+static int compare_i32(const void *a, const void *b) {
+    const int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    bool all = false, quiet = false;
+    int  opt;
+    while ((opt = getopt(argc, argv, "aq")) != -1) {
+        switch (opt) {
+            case 'a':
+                all = true;
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            default:
+                optind = argc;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-a] [-q] traces...\n", argv[0]);
+        return 2;
+    }
+
+    const int trace_count = argc - optind;
+    trace_t  *traces      = calloc(trace_count, sizeof(trace_t));
+    for (int t = 0; t < trace_count; t++) {
+        if (!trace_load(argv[optind + t], &traces[t])) {
+            return 1;
+        }
+    }
+    press_log_t logs[FLAVOR_COUNT] = {0};
+    size_t      trace_begin[FLAVOR_COUNT][trace_count + 1];
+    for (size_t f = 0; f < FLAVOR_COUNT; f++) {
+        run_flavor(&flavors[f], traces, trace_count, &logs[f], trace_begin[f]);
+        if (logs[f].count != logs[0].count) {
+            fprintf(stderr, "flavors: %s saw %zu presses, %s saw %zu\n", flavors[f].name, logs[f].count, flavors[0].name, logs[0].count);
+            return 1;
+        }
+    }
+
+    if (!quiet) {
+        printf("  %5s  %-7s %-4s", "line", "key", "want");
+        for (size_t f = 0; f < FLAVOR_COUNT; f++) {
+            printf(" | %-12s", flavors[f].name);
+        }
+        printf("\n");
+        for (int t = 0; t < trace_count; t++) {
+            printf("%s\n", argv[optind + t]);
+            for (size_t i = trace_begin[0][t]; i < trace_begin[0][t + 1]; i++) {
+                bool differs = false;
+                for (size_t f = 1; f < FLAVOR_COUNT; f++) {
+                    const press_t *a = &logs[0].presses[i], *b = &logs[f].presses[i];
+                    differs |= !same_outcome(a, b) || press_latency(a) != press_latency(b);
+                }
+                if (all || differs) {
+                    print_press(logs, i);
+                }
+            }
+        }
+        printf("\n");
+    }
+
+    // Per flavor: outcome changes against Achordion, misfires and latency.
+    const size_t count     = logs[0].count;
+    int32_t     *latencies = malloc((count + 1) * sizeof(int32_t));
+    printf("%-12s %8s %8s %8s %8s %8s %8s\n", "flavor", "changed", "misfire", "mean", "p90", "max", "vs achd");
+    for (size_t f = 0; f < FLAVOR_COUNT; f++) {
+        uint32_t changed = 0, misfires = 0, samples = 0;
+        int64_t  total = 0, delta = 0;
+        for (size_t i = 0; i < count; i++) {
+            const press_t *press = &logs[f].presses[i];
+            const press_t *base  = &logs[0].presses[i];
+            changed += !same_outcome(press, base);
+            misfires += press_is_misfire(press);
+            if (press->acted) {
+                latencies[samples++] = press_latency(press);
+                total += press_latency(press);
+                if (base->acted) {
+                    delta += press_latency(press) - press_latency(base);
+                }
+            }
+        }
+        qsort(latencies, samples, sizeof(int32_t), compare_i32);
+        printf("%-12s %8u %8u %8.1f %8d %8d %+8.1f\n", flavors[f].name, changed, misfires, samples ? (double)total / samples : 0, samples ? latencies[samples * 90 / 100] : 0, samples ? latencies[samples - 1] : 0, count ? (double)delta / count : 0);
+    }
+    printf("\n%zu presses; latency in ms from press to its last action; '!' marks a misfire against the trace's tap/hold annotation.\n", count);
+    free(latencies);
+    return 0;
+}
@@ -0,0 +1,380 @@
+// Host simulator: fuzz target for Achordion and Layer Lock.
+//
+// Decodes each input as a stream of key presses and releases, clock advances,
+// stalls and deferred callback runs, runs it through process_record_user()
+// and checks invariants after every step and once the keyboard is idle again.
+// A violation prints the step and aborts, so libFuzzer and AFL see a crash.
+//
+//     ./build/fuzz [-n inputs] [-s seed] [-l max_length]
+//     ./build/fuzz [-v] inputs...
+//
+// Without files, generates `-n` random inputs and reports execs per minute;
+// a failing one is saved as fuzz-crash. With files (or `-` for stdin, as
+// AFL's `@@` passes them), runs each once; `-v` prints each step, action and
+// report. Built with clang's -fsanitize=fuzzer and -DSIM_LIBFUZZER, the file is a
+// libFuzzer target instead, see `make fuzz-libfuzzer`.
+//
+// Input format: byte 0 places the start up to 2 s before the 16-bit timer
+// wraps, so every timer comparison straddles the wrap for some inputs. Each
+// following byte is one step:
+//
+//   00-7F  press or release key `b % key count`
+//   80-BF  advance (b & 3F) + 1 ms, scanning every ms
+//   C0-EF  advance ((b & 3F) + 1) * 32 ms, scanning every 8 ms
+//   F0-F7  stall (b & 07) * 128 ms without scanning, then scan once
+//   F8-FB  scan again at the same time
+//   FC-FF  run due deferred callbacks outside a scan
+//
+// Invariants:
+//
+//   - Achordion is never left recursing between steps, nor are settled events
+//     left queued for replay.
+//   - Each unsettled key's hold_timer is at most its timeout ahead of now, and
+//     after a scan it hasn't expired: its deferred callback would have
+//     settled it.
+//   - Once every key is released and timers have run out, Achordion tracks
+//     no key, no mods (eager or otherwise) remain, the report is empty and
+//     only locked layers are on.
+//
+// Achordion's state is static, so this file includes achordion.c instead of
+// linking it, to read the state directly.
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sim.h"
+#include "features/layer_lock.h"
+#include "features/achordion.c"
+
+#define MAX_INPUT 4096
+#define IDLE_AFTER_INPUT 2000
+// Scan intervals for long advances and while idling, to keep them cheap.
+// Timers there only need to expire, not be seen at any particular millisecond.
+#define LONG_SCAN_INTERVAL 8
+#define IDLE_SCAN_INTERVAL 50
+
+static keypos_t       keys[MATRIX_ROWS * MATRIX_COLS];
+static uint8_t        key_count;
+static size_t         step;
+static bool           verbose;
+// Where a failing random input is saved, to rerun it as a file.
+static const char    *crash_path;
+static const uint8_t *input;
+static size_t         input_size;
+
+static void fail(const char *what) {
+    fprintf(stderr, "fuzz: step %zu at %u ms: %s (%u tap-hold keys tracked)\n", step, sim_now(), what, tap_hold_count);
+    for (uint8_t i = 0; i < tap_hold_count; i++) {
+        const tap_hold_key_t *key = &tap_hold_keys[i];
+        fprintf(stderr, "            state %u, keycode 0x%04X, hold_timer %u, eager_mods 0x%02X\n", key->state, key->keycode, key->hold_timer, key->eager_mods);
+    }
+    FILE *file = crash_path ? fopen(crash_path, "wb") : NULL;
+    if (file) {
+        fwrite(input, 1, input_size, file);
+        fclose(file);
+        fprintf(stderr, "fuzz: input saved to %s\n", crash_path);
+    }
+    abort();
+}
+
+// Collects the positions that have a key on the base layer.
+static void collect_keys(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            const keypos_t pos = {.col = col, .row = row};
+            if (keymap_key_to_keycode(0, pos) != KC_NO) {
+                keys[key_count++] = pos;
+            }
+        }
+    }
+}
+
+static void setup(void) {
+    collect_keys();
+    // RECDUMP prints the Key Recorder buffer; keep it out of the way.
+    if (!freopen("/dev/null", "w", stdout)) {
+        perror("/dev/null");
+    }
+}
+
+// Prints a step as it is about to run, for triaging a failing input.
+static void trace_step(uint8_t b) {
+    fprintf(stderr, "%4zu %6u ", step, sim_now());
+    if (b < 0x80) {
+        const keypos_t key = keys[b % key_count];
+        fprintf(stderr, "%s %u,%u 0x%04X\n", sim_key_is_pressed(key) ? "up  " : "down", key.row, key.col, keymap_key_to_keycode(0, key));
+    } else if (b < 0xC0) {
+        fprintf(stderr, "advance %u\n", (b & 0x3F) + 1);
+    } else if (b < 0xF0) {
+        fprintf(stderr, "advance %u\n", ((b & 0x3F) + 1) * 32);
+    } else if (b < 0xF8) {
+        fprintf(stderr, "stall %u\n", (b & 0x07) * 128);
+    } else {
+        fprintf(stderr, b < 0xFC ? "scan\n" : "deferred_exec_task\n");
+    }
+}
+
+static void print_action(const keyrecord_t *record, action_t action, void *ctx) {
+    fprintf(stderr, "            action %04X %u,%u %s tap %u\n", action.code, record->event.key.row, record->event.key.col, record->event.pressed ? "down" : "up", record->tap.count);
+}
+
+static void print_report(const sim_report_t *sent, void *ctx) {
+    const report_keyboard_t *r = &sent->report;
+    fprintf(stderr, "            report mods=%02X keys=%02X %02X %02X %02X %02X %02X\n", r->mods, r->keys[0], r->keys[1], r->keys[2], r->keys[3], r->keys[4], r->keys[5]);
+}
+
+// Returns the simulator and the features to their power-on state.
+static void reset(uint8_t start) {
+    layer_lock_all_off();
+    sim_init();
+    sim_config.rgb_enabled             = false;
+    tap_hold_count          = 0;
+    recursing               = false;
+    streak_timer            = 0;
+    replay_count            = 0;
+    tap_hold_down           = 0;
+    memset(tap_hold_pressed, 0, sizeof(tap_hold_pressed));
+#ifdef ACHORDION_STREAK_TAP_ON_PRESS
+    tapped_on_press_count = 0;
+    memset(tapped_on_press, 0, sizeof(tapped_on_press));
+#endif
+#ifdef ACHORDION_SPECULATIVE_TAP
+    speculating = false;
+#endif
+#ifdef ACHORDION_OVERLAP_HOLD
+    overlap_tap_hold.pressed = false;
+    overlap_other.pressed    = false;
+#endif
+#ifdef DEFERRED_EXEC_ENABLE
+    hold_token              = INVALID_DEFERRED_TOKEN;
+    streak_token            = INVALID_DEFERRED_TOKEN;
+#endif
+    sim_stall((uint16_t)(0 - start * 8));
+    if (verbose) {
+        sim_set_report_hook(print_report, NULL);
+        sim_set_action_hook(print_action, NULL);
+    }
+}
+
+static void check_step(bool scanned) {
+    if (recursing) {
+        fail("left recursing");
+    }
+    if (replay_count) {
+        fail("settled events left queued for replay");
+    }
+    for (uint8_t i = 0; i < tap_hold_count; i++) {
+        const tap_hold_key_t *key = &tap_hold_keys[i];
+        if (key->state != STATE_UNSETTLED) {
+            continue;
+        }
+        if ((int16_t)(key->hold_timer - timer_read()) > (int16_t)achordion_timeout(key->keycode) + 1) {
+            fail("hold_timer further ahead than the timeout");
+        }
+        // A callback expires it at the first scan after, and a scan that
+        // blocked in wait_ms() can leave the clock past the next one's start.
+        if (scanned && timer_expired((uint16_t)sim_last_scan(), key->hold_timer)) {
+            fail("hold_timer expired but the key is unsettled");
+        }
+    }
+}
+
+static void check_idle(void) {
+    if (tap_hold_count) {
+        fail("Achordion still tracking keys after idle");
+    }
+    if (tap_hold_down) {
+        fail("tap-hold keys counted down after idle");
+    }
+#ifdef ACHORDION_STREAK_TAP_ON_PRESS
+    if (tapped_on_press_count) {
+        fail("keys tapped on press not released after idle");
+    }
+#endif
+#ifdef ACHORDION_SPECULATIVE_TAP
+    if (speculating) {
+        fail("tap sent ahead still pending after idle");
+    }
+#endif
+    if (get_mods() || get_weak_mods()) {
+        fail("mods stuck after idle");
+    }
+    const report_keyboard_t *report = sim_last_report();
+    if (report->mods) {
+        fail("mods left in the report");
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i]) {
+            fail("key left in the report");
+        }
+    }
+    for (uint8_t layer = 0; layer < sizeof(layer_state_t) * 8; layer++) {
+        if (layer_state_is(layer) && !is_layer_locked(layer)) {
+            fail("unlocked layer left on");
+        }
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (!key_count) {
+        setup();
+    }
+    if (size == 0) {
+        return 0;
+    }
+    input      = data;
+    input_size = size;
+    reset(data[0]);
+    for (step = 1; step < size; step++) {
+        const uint8_t b = data[step];
+        if (verbose) {
+            trace_step(b);
+        }
+        if (b < 0x80) {
+            const keypos_t key = keys[b % key_count];
+            sim_key(key, !sim_key_is_pressed(key));
+            check_step(false);
+        } else if (b < 0xC0) {
+            sim_advance((b & 0x3F) + 1);
+            check_step(true);
+        } else if (b < 0xF0) {
+            sim_config.scan_interval = LONG_SCAN_INTERVAL;
+            sim_advance(((b & 0x3F) + 1) * 32);
+            sim_config.scan_interval = 1;
+            check_step(true);
+        } else if (b < 0xF8) {
+            sim_stall((b & 0x07) * 128);
+            check_step(true);
+        } else if (b < 0xFC) {
+            sim_scan();
+            check_step(true);
+        } else {
+#ifdef DEFERRED_EXEC_ENABLE
+            deferred_exec_task();
+#else
+            achordion_task();
+#endif
+            check_step(true);
+        }
+    }
+    sim_config.scan_interval = IDLE_SCAN_INTERVAL;
+    sim_quiesce(IDLE_AFTER_INPUT);
+    check_idle();
+    return 0;
+}
+
+#ifndef SIM_LIBFUZZER
+
+static uint32_t rng_state;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int run_file(const char *path) {
+    FILE *file = strcmp(path, "-") ? fopen(path, "rb") : stdin;
+    if (!file) {
+        perror(path);
+        return 1;
+    }
+    static uint8_t data[MAX_INPUT];
+    const size_t   size = fread(data, 1, sizeof(data), file);
+    if (file != stdin) {
+        fclose(file);
+    }
+    LLVMFuzzerTestOneInput(data, size);
+    return 0;
+}
+
+// Random inputs, weighted towards key toggles and advances.
+static void run_random(uint32_t inputs, size_t max_length) {
+    static uint8_t data[MAX_INPUT];
+    const double   start = now_seconds();
+    size_t         steps = 0;
+    for (uint32_t n = 0; n < inputs; n++) {
+        const size_t size = 1 + rng_next() % max_length;
+        data[0]           = rng_next();
+        for (size_t i = 1; i < size; i++) {
+            const uint32_t r = rng_next();
+            switch (r % 8) {
+                case 0:
+                case 1:
+                case 2:
+                    data[i] = (r >> 8) & 0x7F;
+                    break;
+                case 3:
+                case 4:
+                    data[i] = 0x80 | ((r >> 8) & 0x3F);
+                    break;
+                case 5:
+                case 6:
+                    data[i] = 0xC0 | ((r >> 8) & 0x3F);
+                    break;
+                default:
+                    data[i] = 0xF0 | ((r >> 8) & 0x0F);
+            }
+        }
+        LLVMFuzzerTestOneInput(data, size);
+        steps += size;
+    }
+    const double elapsed = now_seconds() - start;
+    fprintf(stderr, "inputs:         %u\n", inputs);
+    fprintf(stderr, "steps:          %zu\n", steps);
+    fprintf(stderr, "host time:      %.3f s\n", elapsed);
+    fprintf(stderr, "execs/min:      %.0f\n", inputs / elapsed * 60);
+}
+
+int main(int argc, char **argv) {
+    uint32_t inputs     = 100000;
+    uint32_t seed       = 1;
+    size_t   max_length = 64;
+    int      opt;
+    while ((opt = getopt(argc, argv, "n:s:l:v")) != -1) {
+        switch (opt) {
+            case 'n':
+                inputs = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            case 'l':
+                max_length = strtoul(optarg, NULL, 0);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n inputs] [-s seed] [-l max_length] [-v] [inputs...]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (max_length < 1 || max_length > MAX_INPUT) {
+        fprintf(stderr, "fuzz: max_length must be 1 to %d\n", MAX_INPUT);
+        return 2;
+    }
+    rng_state = seed ? seed : 1;
+
+    if (optind < argc) {
+        for (int i = optind; i < argc; i++) {
+            if (run_file(argv[i])) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    crash_path = "fuzz-crash";
+    run_random(inputs, max_length);
+    return 0;
+}
+
+#endif // SIM_LIBFUZZER
@@ -0,0 +1,110 @@
+// Host simulator: macro compiler.
+//
+//     ./build/macrogen > build/macro_reports.h
+//
+// Turns each string in macro_strings.h into the keyboard reports that type
+// it, as a PROGMEM array of macro_report_t for features/macro_queue.h, so the
+// firmware sends reports without looking characters up. The Makefile runs it
+// into build/ whenever macro_strings.h changes, and `make macros` copies the
+// output over ../macro_reports.h, which is checked in because the QMK build
+// doesn't run host tools.
+//
+// Every report presses at most one key, so the host sees the characters in
+// order. Otherwise reports are shared wherever the host can't tell the
+// difference:
+//
+//   - A key is released in the same report that presses the next one. Only a
+//     repeated key needs a report of its own in between, to release it.
+//   - Shift goes down or up in a report of its own, which also releases the
+//     last key, before the key it applies to. As features/report_diff.h
+//     keeps it, a mod change never reaches the host with a key press, which
+//     some hosts would apply to the key late or not at all.
+//   - The final report releases everything.
+//
+// So "!=" is 5 reports, Shift, Shift+1, none, =, none, where SEND_STRING()
+// sends 6.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "features/macro_queue.h"
+#include "macro_strings.h"
+
+typedef struct {
+    const char *name;
+    const char *string;
+} macro_string_t;
+
+#define MACRO_STRING_ENTRY(name, string) {#name, string},
+
+static const macro_string_t macros[] = {MACRO_STRINGS(MACRO_STRING_ENTRY)};
+
+// Prints `string` as a C string literal.
+static void print_string(const char *string) {
+    putchar('"');
+    for (const char *c = string; *c; c++) {
+        switch (*c) {
+            case '"':
+            case '\\':
+                printf("\\%c", *c);
+                break;
+            case '\n':
+                printf("\\n");
+                break;
+            case '\t':
+                printf("\\t");
+                break;
+            default:
+                if (*c < ' ' || *c >= 0x7F) {
+                    printf("\\x%02X", (uint8_t)*c);
+                } else {
+                    putchar(*c);
+                }
+        }
+    }
+    putchar('"');
+}
+
+static void print_report(uint8_t mods, uint8_t keycode) {
+    printf("    {0x%02X, 0x%02X},\n", mods, keycode);
+}
+
+// Prints the reports for `macro`. Returns false on a character that can't be
+// typed.
+static bool compile(const macro_string_t *macro) {
+    printf("\n// ");
+    print_string(macro->string);
+    printf("\nstatic const macro_report_t macro_%s[] PROGMEM = {\n", macro->name);
+    uint8_t held      = KC_NO;
+    uint8_t held_mods = 0;
+    for (const char *c = macro->string; *c; c++) {
+        const uint8_t ascii   = *c;
+        const uint8_t keycode = ascii < sizeof(ascii_to_keycode_lut) ? ascii_to_keycode_lut[ascii] : KC_NO;
+        if (keycode == KC_NO) {
+            fprintf(stderr, "macrogen: %s: can't type character 0x%02X\n", macro->name, ascii);
+            return false;
+        }
+        const uint8_t mods = (ascii_to_shift_lut[ascii / 8] >> (ascii % 8)) & 1 ? MOD_BIT(KC_LEFT_SHIFT) : 0;
+        if (mods != held_mods || keycode == held) {
+            print_report(mods, KC_NO);
+        }
+        print_report(mods, keycode);
+        held      = keycode;
+        held_mods = mods;
+    }
+    print_report(0, KC_NO);
+    printf("    {0x00, MACRO_END},\n};\n");
+    return true;
+}
+
+int main(void) {
+    printf("// Generated by sim/macrogen from macro_strings.h, do not edit.\n"
+           "// Each report is {mods, keycode}.\n\n"
+           "#pragma once\n\n"
+           "#include \"features/macro_queue.h\"\n");
+    for (size_t i = 0; i < sizeof(macros) / sizeof(macros[0]); i++) {
+        if (!compile(&macros[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Host simulator: per-press tap-hold outcomes.
+
+#include <stdlib.h>
+#include <string.h>
+#include "press_log.h"
+
+static void on_action(const keyrecord_t *record, action_t action, void *ctx) {
+    press_log_t   *log = ctx;
+    const keypos_t key = record->event.key;
+    if (!record->event.pressed || !IS_KEYEVENT(record->event) || log->press_of[key.row][key.col] < 0) {
+        return;
+    }
+    press_t *press     = &log->presses[log->press_of[key.row][key.col]];
+    press->acted       = true;
+    press->action_time = sim_now();
+    press->tap_hold    = sim_is_tap_hold_action(action);
+    press->held        = press->tap_hold && record->tap.count == 0;
+}
+
+void press_log_attach(press_log_t *log) {
+    log->count = 0;
+    press_log_start_trace(log);
+    sim_set_action_hook(on_action, log);
+}
+
+void press_log_start_trace(press_log_t *log) {
+    memset(log->press_of, 0xFF, sizeof(log->press_of));
+}
+
+void press_log_key(press_log_t *log, const trace_event_t *event) {
+    if (event->pressed) {
+        if (log->count == log->capacity) {
+            log->capacity = log->capacity ? log->capacity * 2 : 1024;
+            log->presses  = realloc(log->presses, log->capacity * sizeof(press_t));
+            if (!log->presses) {
+                perror("realloc");
+                exit(1);
+            }
+        }
+        log->presses[log->count] = (press_t){
+            .press_time = sim_now(),
+            .key        = event->key,
+            .line       = event->line,
+            .intent     = event->intent,
+        };
+        log->press_of[event->key.row][event->key.col] = log->count++;
+    }
+    sim_key(event->key, event->pressed);
+}
+
+bool press_is_misfire(const press_t *press) {
+    // A press that never acted was swallowed, which goes against either intent.
+    switch (press->intent) {
+        case TRACE_INTENT_TAP:
+            return !press->acted || press->held;
+        case TRACE_INTENT_HOLD:
+            return !press->acted || !press->held;
+    }
+    return false;
+}
+
+int32_t press_latency(const press_t *press) {
+    return press->acted ? (int32_t)(press->action_time - press->press_time) : -1;
+}
+
+void press_log_free(press_log_t *log) {
+    free(log->presses);
+    *log = (press_log_t){0};
+}
@@ -0,0 +1,49 @@
+// Host simulator: per-press tap-hold outcomes.
+//
+// Follows every physical press through the simulator and records what it
+// finally did: whether it acted at all, whether a tap-hold key came out
+// tapped or held, and when its last action ran. Used to score traces against
+// their `tap`/`hold` intent annotations and to compare tap-hold settings.
+//
+//     press_log_t log = {0};
+//     press_log_attach(&log);      // after sim_init()
+//     for each event: press_log_key(&log, &event);
+
+#pragma once
+
+#include "trace.h"
+
+typedef struct {
+    uint32_t press_time;  // Virtual time of the physical press.
+    uint32_t action_time; // Virtual time of the last action it produced.
+    keypos_t key;
+    uint32_t line;   // Trace line or record of the press.
+    uint8_t  intent; // TRACE_INTENT_*
+    bool     acted;
+    bool     tap_hold; // Its last action was a mod-tap or layer-tap.
+    bool     held;     // ... and ran as a hold.
+} press_t;
+
+typedef struct {
+    press_t *presses;
+    size_t   count;
+    size_t   capacity;
+    int32_t  press_of[MATRIX_ROWS][MATRIX_COLS];
+} press_log_t;
+
+/** Installs the simulator action hook that fills `log`. Call after sim_init(). */
+void press_log_attach(press_log_t *log);
+
+/** Forgets which press each key belongs to, e.g. between traces. */
+void press_log_start_trace(press_log_t *log);
+
+/** Logs `event` if it is a press, then feeds it to the simulator. */
+void press_log_key(press_log_t *log, const trace_event_t *event);
+
+/** Returns true if the press is annotated and came out against its intent. */
+bool press_is_misfire(const press_t *press);
+
+/** Output latency of the press in ms, or -1 if it never acted. */
+int32_t press_latency(const press_t *press);
+
+void press_log_free(press_log_t *log);
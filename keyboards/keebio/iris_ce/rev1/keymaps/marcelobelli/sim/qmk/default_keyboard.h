@@ -0,0 +1,35 @@
+// Host simulator: stand-in for the generated keebio/iris_ce/rev1 keyboard header.
+//
+// 10x6 split matrix, rows 0-4 on the left half and rows 5-9 on the right half,
+// with right-hand columns mirrored so that column 0 is the outer edge on both
+// halves. 56 per-key LEDs in LAYOUT order, followed by 12 underglow LEDs.
+
+#pragma once
+
+#define MATRIX_ROWS 10
+#define MATRIX_COLS 6
+#define RGB_MATRIX_LED_COUNT 68
+
+// clang-format off
+#define IRIS_MATRIX( \
+    NA, \
+    LA0, LA1, LA2, LA3, LA4, LA5, RA0, RA1, RA2, RA3, RA4, RA5, \
+    LB0, LB1, LB2, LB3, LB4, LB5, RB0, RB1, RB2, RB3, RB4, RB5, \
+    LC0, LC1, LC2, LC3, LC4, LC5, RC0, RC1, RC2, RC3, RC4, RC5, \
+    LD0, LD1, LD2, LD3, LD4, LD5, LX, RX, RD0, RD1, RD2, RD3, RD4, RD5, \
+    LT0, LT1, LT2, RT0, RT1, RT2 \
+) { \
+    { LA0, LA1, LA2, LA3, LA4, LA5 }, \
+    { LB0, LB1, LB2, LB3, LB4, LB5 }, \
+    { LC0, LC1, LC2, LC3, LC4, LC5 }, \
+    { LD0, LD1, LD2, LD3, LD4, LD5 }, \
+    { NA, NA, LT0, LT1, LT2, LX }, \
+    { RA5, RA4, RA3, RA2, RA1, RA0 }, \
+    { RB5, RB4, RB3, RB2, RB1, RB0 }, \
+    { RC5, RC4, RC3, RC2, RC1, RC0 }, \
+    { RD5, RD4, RD3, RD2, RD1, RD0 }, \
+    { NA, NA, RT2, RT1, RT0, RX } \
+}
+// clang-format on
+
+#define LAYOUT(...) IRIS_MATRIX(KC_NO, __VA_ARGS__)
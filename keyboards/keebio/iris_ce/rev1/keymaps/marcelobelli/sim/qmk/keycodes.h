@@ -0,0 +1,282 @@
+// Host simulator: subset of QMK's keycode space.
+//
+// Values match quantum/keycodes.h and quantum/modifiers.h so that keycodes
+// printed by the firmware console and the simulator are interchangeable.
+
+#pragma once
+
+#include <stdint.h>
+
+// clang-format off
+enum qk_keycode_ranges {
+    QK_BASIC                = 0x0000,
+    QK_BASIC_MAX            = 0x00FF,
+    QK_MODS                 = 0x0100,
+    QK_MODS_MAX             = 0x1FFF,
+    QK_MOD_TAP              = 0x2000,
+    QK_MOD_TAP_MAX          = 0x3FFF,
+    QK_LAYER_TAP            = 0x4000,
+    QK_LAYER_TAP_MAX        = 0x4FFF,
+    QK_LAYER_MOD            = 0x5000,
+    QK_LAYER_MOD_MAX        = 0x51FF,
+    QK_TO                   = 0x5200,
+    QK_TO_MAX               = 0x521F,
+    QK_MOMENTARY            = 0x5220,
+    QK_MOMENTARY_MAX        = 0x523F,
+    QK_DEF_LAYER            = 0x5240,
+    QK_DEF_LAYER_MAX        = 0x525F,
+    QK_TOGGLE_LAYER         = 0x5260,
+    QK_TOGGLE_LAYER_MAX     = 0x527F,
+    QK_ONE_SHOT_LAYER       = 0x5280,
+    QK_ONE_SHOT_LAYER_MAX   = 0x529F,
+    QK_ONE_SHOT_MOD         = 0x52A0,
+    QK_ONE_SHOT_MOD_MAX     = 0x52BF,
+    QK_LAYER_TAP_TOGGLE     = 0x52C0,
+    QK_LAYER_TAP_TOGGLE_MAX = 0x52DF,
+    QK_QUANTUM              = 0x7C00,
+    QK_QUANTUM_MAX          = 0x7DFF,
+    QK_USER                 = 0x7E40,
+    QK_USER_MAX             = 0x7FFF,
+};
+
+enum qk_keycode_defines {
+    KC_NO                   = 0x0000,
+    KC_TRANSPARENT          = 0x0001,
+    KC_A                    = 0x0004,
+    KC_B                    = 0x0005,
+    KC_C                    = 0x0006,
+    KC_D                    = 0x0007,
+    KC_E                    = 0x0008,
+    KC_F                    = 0x0009,
+    KC_G                    = 0x000A,
+    KC_H                    = 0x000B,
+    KC_I                    = 0x000C,
+    KC_J                    = 0x000D,
+    KC_K                    = 0x000E,
+    KC_L                    = 0x000F,
+    KC_M                    = 0x0010,
+    KC_N                    = 0x0011,
+    KC_O                    = 0x0012,
+    KC_P                    = 0x0013,
+    KC_Q                    = 0x0014,
+    KC_R                    = 0x0015,
+    KC_S                    = 0x0016,
+    KC_T                    = 0x0017,
+    KC_U                    = 0x0018,
+    KC_V                    = 0x0019,
+    KC_W                    = 0x001A,
+    KC_X                    = 0x001B,
+    KC_Y                    = 0x001C,
+    KC_Z                    = 0x001D,
+    KC_1                    = 0x001E,
+    KC_2                    = 0x001F,
+    KC_3                    = 0x0020,
+    KC_4                    = 0x0021,
+    KC_5                    = 0x0022,
+    KC_6                    = 0x0023,
+    KC_7                    = 0x0024,
+    KC_8                    = 0x0025,
+    KC_9                    = 0x0026,
+    KC_0                    = 0x0027,
+    KC_ENTER                = 0x0028,
+    KC_ESCAPE               = 0x0029,
+    KC_BACKSPACE            = 0x002A,
+    KC_TAB                  = 0x002B,
+    KC_SPACE                = 0x002C,
+    KC_MINUS                = 0x002D,
+    KC_EQUAL                = 0x002E,
+    KC_LEFT_BRACKET         = 0x002F,
+    KC_RIGHT_BRACKET        = 0x0030,
+    KC_BACKSLASH            = 0x0031,
+    KC_SEMICOLON            = 0x0033,
+    KC_QUOTE                = 0x0034,
+    KC_GRAVE                = 0x0035,
+    KC_COMMA                = 0x0036,
+    KC_DOT                  = 0x0037,
+    KC_SLASH                = 0x0038,
+    KC_CAPS_LOCK            = 0x0039,
+    KC_HOME                 = 0x004A,
+    KC_PAGE_UP              = 0x004B,
+    KC_DELETE               = 0x004C,
+    KC_END                  = 0x004D,
+    KC_PAGE_DOWN            = 0x004E,
+    KC_RIGHT                = 0x004F,
+    KC_LEFT                 = 0x0050,
+    KC_DOWN                 = 0x0051,
+    KC_UP                   = 0x0052,
+    KC_KP_SLASH             = 0x0054,
+    KC_KP_ASTERISK          = 0x0055,
+    KC_KP_MINUS             = 0x0056,
+    KC_KP_PLUS              = 0x0057,
+    KC_KP_EQUAL             = 0x0067,
+    KC_AUDIO_MUTE           = 0x00A8,
+    KC_AUDIO_VOL_UP         = 0x00A9,
+    KC_AUDIO_VOL_DOWN       = 0x00AA,
+    KC_MEDIA_NEXT_TRACK     = 0x00AB,
+    KC_MEDIA_PREV_TRACK     = 0x00AC,
+    KC_MEDIA_STOP           = 0x00AD,
+    KC_MEDIA_PLAY_PAUSE     = 0x00AE,
+    KC_LEFT_CTRL            = 0x00E0,
+    KC_LEFT_SHIFT           = 0x00E1,
+    KC_LEFT_ALT             = 0x00E2,
+    KC_LEFT_GUI             = 0x00E3,
+    KC_RIGHT_CTRL           = 0x00E4,
+    KC_RIGHT_SHIFT          = 0x00E5,
+    KC_RIGHT_ALT            = 0x00E6,
+    KC_RIGHT_GUI            = 0x00E7,
+    QK_BOOTLOADER           = 0x7C00,
+    QK_CLEAR_EEPROM         = 0x7C03,
+    SAFE_RANGE              = QK_USER,
+};
+
+#define KC_TRNS KC_TRANSPARENT
+#define KC_ENT  KC_ENTER
+#define KC_ESC  KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC  KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL  KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV  KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_PGUP KC_PAGE_UP
+#define KC_DEL  KC_DELETE
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_RGHT KC_RIGHT
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MNXT KC_MEDIA_NEXT_TRACK
+#define KC_MPRV KC_MEDIA_PREV_TRACK
+#define KC_MSTP KC_MEDIA_STOP
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LOPT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_LCMD KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_ROPT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+#define KC_RCMD KC_RIGHT_GUI
+#define QK_BOOT QK_BOOTLOADER
+#define EE_CLR  QK_CLEAR_EEPROM
+
+// 5-bit modifier codes, as used in MT() and LM().
+enum mods_5bit {
+    MOD_LCTL = 0x01,
+    MOD_LSFT = 0x02,
+    MOD_LALT = 0x04,
+    MOD_LGUI = 0x08,
+    MOD_RCTL = 0x11,
+    MOD_RSFT = 0x12,
+    MOD_RALT = 0x14,
+    MOD_RGUI = 0x18,
+};
+#define MOD_HYPR (MOD_LCTL | MOD_LSFT | MOD_LALT | MOD_LGUI)
+#define MOD_MEH  (MOD_LCTL | MOD_LSFT | MOD_LALT)
+
+// 8-bit modifier bits, as found in the HID report.
+enum mods_8bit {
+    MOD_BIT_LCTRL  = 0x01,
+    MOD_BIT_LSHIFT = 0x02,
+    MOD_BIT_LALT   = 0x04,
+    MOD_BIT_LGUI   = 0x08,
+    MOD_BIT_RCTRL  = 0x10,
+    MOD_BIT_RSHIFT = 0x20,
+    MOD_BIT_RALT   = 0x40,
+    MOD_BIT_RGUI   = 0x80,
+};
+#define MOD_BIT(code)   (1 << ((code) & 0x07))
+#define MOD_MASK_CTRL   (MOD_BIT_LCTRL | MOD_BIT_RCTRL)
+#define MOD_MASK_SHIFT  (MOD_BIT_LSHIFT | MOD_BIT_RSHIFT)
+#define MOD_MASK_ALT    (MOD_BIT_LALT | MOD_BIT_RALT)
+#define MOD_MASK_GUI    (MOD_BIT_LGUI | MOD_BIT_RGUI)
+#define MOD_MASK_CG     (MOD_MASK_CTRL | MOD_MASK_GUI)
+
+#define IS_BASIC_KEYCODE(code)    ((code) >= KC_A && (code) <= 0x00A4)
+#define IS_MODIFIER_KEYCODE(code) ((code) >= KC_LEFT_CTRL && (code) <= KC_RIGHT_GUI)
+
+// Modified keys.
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_RCTL 0x1100
+#define QK_RSFT 0x1200
+#define QK_RALT 0x1400
+#define QK_RGUI 0x1800
+
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define LOPT(kc) LALT(kc)
+#define LCMD(kc) LGUI(kc)
+#define RCTL(kc) (QK_RCTL | (kc))
+#define RSFT(kc) (QK_RSFT | (kc))
+#define RALT(kc) (QK_RALT | (kc))
+#define RGUI(kc) (QK_RGUI | (kc))
+#define ROPT(kc) RALT(kc)
+#define RCMD(kc) RGUI(kc)
+#define S(kc)    LSFT(kc)
+
+#define QK_MODS_GET_MODS(kc)        (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+
+// Shifted US ANSI symbols.
+#define KC_UNDS                KC_UNDERSCORE
+#define KC_UNDERSCORE          S(KC_MINUS)
+#define KC_LEFT_CURLY_BRACE    S(KC_LEFT_BRACKET)
+#define KC_RIGHT_CURLY_BRACE   S(KC_RIGHT_BRACKET)
+#define KC_LEFT_PAREN          S(KC_9)
+#define KC_RIGHT_PAREN         S(KC_0)
+#define KC_LEFT_ANGLE_BRACKET  S(KC_COMMA)
+#define KC_RIGHT_ANGLE_BRACKET S(KC_DOT)
+
+// Mod-tap.
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LCTL_T(kc)  MT(MOD_LCTL, kc)
+#define CTL_T(kc)   LCTL_T(kc)
+#define LSFT_T(kc)  MT(MOD_LSFT, kc)
+#define SFT_T(kc)   LSFT_T(kc)
+#define LALT_T(kc)  MT(MOD_LALT, kc)
+#define LOPT_T(kc)  LALT_T(kc)
+#define LGUI_T(kc)  MT(MOD_LGUI, kc)
+#define LCMD_T(kc)  LGUI_T(kc)
+#define RCTL_T(kc)  MT(MOD_RCTL, kc)
+#define RSFT_T(kc)  MT(MOD_RSFT, kc)
+#define RALT_T(kc)  MT(MOD_RALT, kc)
+#define ROPT_T(kc)  RALT_T(kc)
+#define RGUI_T(kc)  MT(MOD_RGUI, kc)
+#define RCMD_T(kc)  RGUI_T(kc)
+#define HYPR_T(kc)  MT(MOD_HYPR, kc)
+#define MEH_T(kc)   MT(MOD_MEH, kc)
+
+#define IS_QK_MOD_TAP(code)              ((code) >= QK_MOD_TAP && (code) <= QK_MOD_TAP_MAX)
+#define QK_MOD_TAP_GET_MODS(kc)          (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc)   ((kc) & 0xFF)
+
+// Layer keys.
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define LM(layer, mod) (QK_LAYER_MOD | (((layer) & 0xF) << 5) | ((mod) & 0x1F))
+#define MO(layer)     (QK_MOMENTARY | ((layer) & 0x1F))
+#define TT(layer)     (QK_LAYER_TAP_TOGGLE | ((layer) & 0x1F))
+
+#define IS_QK_LAYER_TAP(code)             ((code) >= QK_LAYER_TAP && (code) <= QK_LAYER_TAP_MAX)
+#define QK_LAYER_TAP_GET_LAYER(kc)        (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc)  ((kc) & 0xFF)
+#define QK_LAYER_MOD_GET_LAYER(kc)        (((kc) >> 5) & 0xF)
+#define QK_LAYER_MOD_GET_MODS(kc)         ((kc) & 0x1F)
+#define QK_MOMENTARY_GET_LAYER(kc)        ((kc) & 0x1F)
+#define QK_LAYER_TAP_TOGGLE_GET_LAYER(kc) ((kc) & 0x1F)
+// clang-format on
@@ -0,0 +1,42 @@
+// Host simulator: the lib8tion math that RGB Matrix effects use, ported
+// from QMK's lib/lib8tion with FASTLED_SCALE8_FIXED, so effects compute the
+// same values as on the board.
+
+#pragma once
+
+#include <stdint.h>
+
+static inline uint8_t scale8(uint8_t i, uint8_t scale) {
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+static inline uint16_t scale16by8(uint16_t i, uint8_t scale) {
+    return (i * (1 + (uint16_t)scale)) >> 8;
+}
+
+static inline int8_t abs8(int8_t i) {
+    return i < 0 ? -i : i;
+}
+
+static inline uint8_t sin8(uint8_t theta) {
+    static const uint8_t b_m16_interleave[8] = {0, 49, 49, 41, 90, 27, 117, 10};
+
+    uint8_t offset = theta;
+    if (theta & 0x40) {
+        offset = 255 - offset;
+    }
+    offset &= 0x3F;
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) {
+        secoffset++;
+    }
+    const uint8_t section = offset >> 4;
+    const uint8_t b       = b_m16_interleave[section * 2];
+    const uint8_t m16     = b_m16_interleave[section * 2 + 1];
+    const uint8_t mx      = (m16 * secoffset) >> 4;
+    int8_t        y       = mx + b;
+    if (theta & 0x80) {
+        y = -y;
+    }
+    return y + 128;
+}
@@ -0,0 +1,5 @@
+// Host simulator: forwards to the mocked QMK core.
+
+#pragma once
+
+#include "quantum.h"
@@ -0,0 +1,320 @@
+// Host simulator: mocked QMK core.
+//
+// Just enough of quantum/ to compile keymap.c and features/ on the host. The
+// matching implementation lives in sim/sim_core.c. Everything here is driven
+// by the simulator's virtual clock; see sim/sim.h for the driver API.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "keycodes.h"
+#include "lib8tion.h"
+#include QMK_KEYBOARD_H
+
+#ifndef TAPPING_TERM
+#    define TAPPING_TERM 200
+#endif
+#ifndef QUICK_TAP_TERM
+#    define QUICK_TAP_TERM TAPPING_TERM
+#endif
+#ifndef TAP_CODE_DELAY
+#    define TAP_CODE_DELAY 0
+#endif
+#ifndef TAP_HOLD_CAPS_DELAY
+#    define TAP_HOLD_CAPS_DELAY 80
+#endif
+
+#define PROGMEM
+#define PSTR(s) s
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+
+/* Debug console. */
+extern bool debug_enable;
+#define dprintf(...)             \
+    do {                         \
+        if (debug_enable) {      \
+            printf(__VA_ARGS__); \
+        }                        \
+    } while (0)
+#define dprintln(s) dprintf("%s\n", s)
+#define dprint(s) dprintf("%s", s)
+#define uprintf printf
+
+/* Timer. */
+#define TIMER_DIFF_16(a, b) (uint16_t)((a) - (b))
+#define TIMER_DIFF_32(a, b) (uint32_t)((a) - (b))
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+#define timer_expired(current, future) ((uint16_t)(current - future) < UINT16_MAX / 2)
+#define timer_expired32(current, future) ((uint32_t)(current - future) < UINT32_MAX / 2)
+void wait_ms(uint16_t ms);
+
+/* Deferred execution. */
+#ifdef DEFERRED_EXEC_ENABLE
+#    ifndef MAX_DEFERRED_EXECUTORS
+#        define MAX_DEFERRED_EXECUTORS 8
+#    endif
+typedef uint8_t deferred_token;
+#    define INVALID_DEFERRED_TOKEN 0
+typedef uint32_t (*deferred_exec_callback)(uint32_t trigger_time, void *cb_arg);
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg);
+bool           extend_deferred_exec(deferred_token token, uint32_t delay_ms);
+bool           cancel_deferred_exec(deferred_token token);
+void           deferred_exec_task(void);
+#endif
+
+/* Key events. */
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef enum keyevent_type_t { TICK_EVENT = 0, KEY_EVENT = 1, ENCODER_CW_EVENT = 2, ENCODER_CCW_EVENT = 3, COMBO_EVENT = 4, DIP_SWITCH_ON_EVENT = 5, DIP_SWITCH_OFF_EVENT = 6 } keyevent_type_t;
+
+typedef struct {
+    keypos_t key;
+    uint16_t time;
+    uint8_t  type;
+    bool     pressed;
+} keyevent_t;
+
+typedef struct {
+    bool    interrupted : 1;
+    bool    reserved2 : 1;
+    bool    reserved1 : 1;
+    bool    reserved0 : 1;
+    uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+    keyevent_t event;
+    tap_t      tap;
+} keyrecord_t;
+
+#define IS_NOEVENT(event) ((event).type == TICK_EVENT)
+#define IS_EVENT(event) ((event).type != TICK_EVENT)
+#define IS_KEYEVENT(event) ((event).type == KEY_EVENT)
+#define IS_COMBOEVENT(event) ((event).type == COMBO_EVENT)
+
+/* Actions. */
+typedef union {
+    uint16_t code;
+} action_t;
+
+enum action_kind_id {
+    ACT_LMODS         = 0x0,
+    ACT_RMODS         = 0x1,
+    ACT_LMODS_TAP     = 0x2,
+    ACT_RMODS_TAP     = 0x3,
+    ACT_LAYER_TAP     = 0xA,
+    ACT_LAYER_TAP_EXT = 0xB,
+};
+#define OP_ON_OFF 0xF1
+
+#define ACTION(kind, param) ((kind) << 12 | (param))
+#define ACTION_NO 0
+#define ACTION_KEY(key) ACTION(ACT_LMODS, (key))
+#define ACTION_MODS_KEY(mods, key) ACTION(((mods) & 0x10) ? ACT_RMODS : ACT_LMODS, ((mods) & 0xF) << 8 | (key))
+#define ACTION_MODS(mods) ACTION_MODS_KEY(mods, 0)
+#define ACTION_MODS_TAP_KEY(mods, key) ACTION(((mods) & 0x10) ? ACT_RMODS_TAP : ACT_LMODS_TAP, ((mods) & 0xF) << 8 | (key))
+#define ACTION_LAYER_TAP(layer, key) ACTION(ACT_LAYER_TAP, (layer) << 8 | (key))
+#define ACTION_LAYER_TAP_KEY(layer, key) ACTION_LAYER_TAP(layer, key)
+#define ACTION_LAYER_MOMENTARY(layer) ACTION_LAYER_TAP(layer, OP_ON_OFF)
+
+void     process_record(keyrecord_t *record);
+void     process_action(keyrecord_t *record, action_t action);
+uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
+uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
+action_t action_for_keycode(uint16_t keycode);
+
+/* Layers. */
+typedef uint32_t layer_state_t;
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+void          layer_state_set(layer_state_t state);
+bool          layer_state_is(uint8_t layer);
+void          layer_clear(void);
+void          layer_move(uint8_t layer);
+void          layer_on(uint8_t layer);
+void          layer_off(uint8_t layer);
+void          layer_invert(uint8_t layer);
+void          layer_or(layer_state_t state);
+void          layer_and(layer_state_t state);
+uint8_t       get_highest_layer(layer_state_t state);
+layer_state_t layer_state_set_user(layer_state_t state);
+uint8_t       get_oneshot_layer(void);
+void          reset_oneshot_layer(void);
+
+/* Modifiers and the keyboard report. */
+#define KEYBOARD_REPORT_KEYS 6
+typedef struct {
+    uint8_t mods;
+    uint8_t reserved;
+    uint8_t keys[KEYBOARD_REPORT_KEYS];
+} report_keyboard_t;
+
+extern report_keyboard_t *keyboard_report;
+
+uint8_t get_mods(void);
+void    add_mods(uint8_t mods);
+void    del_mods(uint8_t mods);
+void    set_mods(uint8_t mods);
+void    clear_mods(void);
+uint8_t get_weak_mods(void);
+void    add_weak_mods(uint8_t mods);
+void    del_weak_mods(uint8_t mods);
+void    clear_weak_mods(void);
+void    register_mods(uint8_t mods);
+void    unregister_mods(uint8_t mods);
+void    add_key(uint8_t key);
+void    del_key(uint8_t key);
+void    clear_keys(void);
+void    clear_keyboard(void);
+void    send_keyboard_report(void);
+uint8_t mod_config(uint8_t mod);
+
+void register_code(uint8_t code);
+void unregister_code(uint8_t code);
+void tap_code(uint8_t code);
+void register_code16(uint16_t code);
+void unregister_code16(uint16_t code);
+void tap_code16(uint16_t code);
+
+// Bit c of the shift table is set if ASCII c is typed with Shift.
+extern const uint8_t ascii_to_shift_lut[16];
+extern const uint8_t ascii_to_keycode_lut[128];
+void                 send_string(const char *string);
+void                 send_char(char ascii_code);
+#define SEND_STRING(string) send_string(PSTR(string))
+
+/* Host driver. Only the keyboard report goes to the host. */
+typedef struct {
+    uint8_t (*keyboard_leds)(void);
+    void (*send_keyboard)(report_keyboard_t *report);
+} host_driver_t;
+
+host_driver_t *host_get_driver(void);
+void           host_set_driver(host_driver_t *driver);
+void           host_keyboard_send(report_keyboard_t *report);
+
+/* Keymap. */
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+
+/* User hooks, weakly defined by the simulator. */
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record);
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
+void matrix_scan_user(void);
+void housekeeping_task_user(void);
+void keyboard_post_init_user(void);
+// With TAPPING_TERM_PER_KEY, the tapping term of the key being decided. The
+// weak default is `sim_config.tapping_term`.
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
+
+/* Split keyboard. The simulated board is always the master half. */
+bool is_keyboard_master(void);
+
+/* Caps Word. */
+bool is_caps_word_on(void);
+
+/* RGB Matrix. */
+typedef struct {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} HSV;
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} RGB;
+
+#define HSV_BLACK 0, 0, 0
+#define RGB_BLACK 0, 0, 0
+#define NO_LED 255
+
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+} led_point_t;
+
+typedef struct {
+    uint8_t     matrix_co[MATRIX_ROWS][MATRIX_COLS];
+    led_point_t point[RGB_MATRIX_LED_COUNT];
+    uint8_t     flags[RGB_MATRIX_LED_COUNT];
+} led_config_t;
+
+extern led_config_t g_led_config;
+
+#define LED_FLAG_UNDERGLOW 0x02
+#define LED_FLAG_KEYLIGHT 0x04
+#define LED_FLAG_ALL 0xFF
+#define HAS_ANY_FLAGS(bits, flags) (((bits) & (flags)) != 0)
+
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+#    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
+#endif
+#ifndef RGB_MATRIX_LED_FLUSH_LIMIT
+#    define RGB_MATRIX_LED_FLUSH_LIMIT 16
+#endif
+#ifndef RGB_MATRIX_DEFAULT_SPD
+#    define RGB_MATRIX_DEFAULT_SPD 127
+#endif
+
+// The effects the simulator renders, and the keymap's own from
+// rgb_matrix_user.inc, numbered as QMK numbers them.
+enum rgb_matrix_effects {
+    RGB_MATRIX_NONE = 0,
+    RGB_MATRIX_SOLID_COLOR,
+    RGB_MATRIX_BREATHING,
+#ifdef RGB_MATRIX_CUSTOM_USER
+#    define RGB_MATRIX_EFFECT(name) RGB_MATRIX_CUSTOM_##name,
+#    include "rgb_matrix_user.inc"
+#    undef RGB_MATRIX_EFFECT
+#endif
+    RGB_MATRIX_EFFECT_MAX
+};
+
+typedef struct {
+    uint8_t mode;
+    HSV     hsv;
+    uint8_t speed;
+    uint8_t flags;
+} rgb_config_t;
+
+typedef struct {
+    uint8_t iter;
+    uint8_t flags;
+    // Set for the first call of a newly selected effect.
+    bool init;
+} effect_params_t;
+
+extern rgb_config_t rgb_matrix_config;
+// Time in ms, as of the start of the current frame.
+extern uint32_t g_rgb_timer;
+
+#define RGB_MATRIX_USE_LIMITS(min, max)                          \
+    uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;   \
+    uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;            \
+    if (max > RGB_MATRIX_LED_COUNT) max = RGB_MATRIX_LED_COUNT
+#define RGB_MATRIX_TEST_LED_FLAGS() \
+    if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
+
+RGB     hsv_to_rgb(HSV hsv);
+#define rgb_matrix_hsv_to_rgb hsv_to_rgb
+void    rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+void    rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
+void    rgb_matrix_sethsv(uint16_t hue, uint8_t sat, uint8_t val);
+void    rgb_matrix_sethsv_noeeprom(uint16_t hue, uint8_t sat, uint8_t val);
+uint8_t rgb_matrix_get_val(void);
+bool    rgb_matrix_check_finished_leds(uint8_t led_idx);
+bool    rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
+#define rgblight_get_val rgb_matrix_get_val
@@ -0,0 +1,21 @@
+// Host simulator: split transport user RPCs.
+//
+// The simulated board has no other half. transaction_rpc_send() runs the
+// handler registered on this board in place, as the other half would, and
+// counts the message in sim_stats.split_transactions.
+
+#pragma once
+
+#include "quantum.h"
+
+enum serial_transaction_id {
+#ifdef SPLIT_TRANSACTION_IDS_USER
+    SPLIT_TRANSACTION_IDS_USER,
+#endif
+    NUM_TOTAL_TRANSACTIONS
+};
+
+typedef void (*slave_callback_t)(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
+bool transaction_rpc_send(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer);
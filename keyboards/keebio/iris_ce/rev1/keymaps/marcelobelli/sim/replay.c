@@ -0,0 +1,224 @@
+// Host simulator: golden trace replay.
+//
+// Replays each trace through the keymap and compares the host report stream
+// with the trace's .golden file (same path, extension replaced by .golden). The
+// golden file ends with deterministic cost counters, so extra process_record()
+// calls or reports show up as a diff even when the output is unchanged. Then
+// the trace is replayed repeatedly to measure host throughput and the
+// worst-case cost of a single event.
+//
+//     ./build/replay [-u] [-r repeats] corpus/*.trace capture.ktr ...
+//
+//   -u  write the .golden files instead of checking them
+//   -r  timing repetitions per trace (default 200, 0 to skip timing)
+//
+// Each trace runs in its own process, so feature state (locked layers, streak
+// timers, ...) never leaks from one trace into the next.
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "trace_bin.h"
+
+#define IDLE_AFTER_TRACE 2000
+
+typedef struct {
+    char  *data;
+    size_t len;
+    size_t capacity;
+} text_t;
+
+static void text_append(text_t *text, const char *line) {
+    const size_t n = strlen(line);
+    if (text->len + n + 2 > text->capacity) {
+        text->capacity = (text->len + n + 2) * 2;
+        text->data     = realloc(text->data, text->capacity);
+        if (!text->data) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memcpy(text->data + text->len, line, n);
+    text->len += n;
+    text->data[text->len++] = '\n';
+    text->data[text->len]   = '\0';
+}
+
+static uint32_t trace_start;
+
+static void record_report(const sim_report_t *sent, void *ctx) {
+    char line[128];
+    trace_format_report(sent, trace_start, line, sizeof(line));
+    text_append(ctx, line);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Replays `trace` once from the current time. When `costs` is given, each
+// entry is lowered to the host time that event took, if smaller. Returns the
+// host time spent on the trace, excluding the idle period after it.
+static uint64_t replay_once(const trace_t *trace, uint64_t *costs) {
+    const uint64_t start = now_ns();
+    trace_start          = sim_now();
+    for (size_t i = 0; i < trace->count; i++) {
+        const trace_event_t *event = &trace->events[i];
+        sim_advance_to(trace_start + event->time);
+        if (costs) {
+            const uint64_t begin = now_ns();
+            sim_key(event->key, event->pressed);
+            const uint64_t cost = now_ns() - begin;
+            if (cost < costs[i]) {
+                costs[i] = cost;
+            }
+        } else {
+            sim_key(event->key, event->pressed);
+        }
+    }
+    const uint64_t elapsed = now_ns() - start;
+    sim_quiesce(IDLE_AFTER_TRACE);
+    return elapsed;
+}
+
+static char *read_file(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return NULL;
+    }
+    text_t text = {0};
+    char   line[256];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\n")] = '\0';
+        text_append(&text, line);
+    }
+    fclose(file);
+    return text.data ? text.data : calloc(1, 1);
+}
+
+// Prints the first few differing lines between `expected` and `actual`.
+static void print_diff(const char *path, const char *expected, const char *actual) {
+    uint32_t line  = 1;
+    uint8_t  shown = 0;
+    while ((*expected || *actual) && shown < 8) {
+        const size_t e = strcspn(expected, "\n");
+        const size_t a = strcspn(actual, "\n");
+        if (e != a || strncmp(expected, actual, e) != 0) {
+            printf("  %s:%u\n    expected: %.*s\n    actual:   %.*s\n", path, line, (int)e, expected, (int)a, actual);
+            shown++;
+        }
+        expected += e + (expected[e] == '\n');
+        actual += a + (actual[a] == '\n');
+        line++;
+    }
+}
+
+static int run_trace(const char *path, bool update, uint32_t repeats) {
+    trace_t trace = {0};
+    if (!trace_load(path, &trace)) {
+        return 2;
+    }
+
+    char        golden_path[512];
+    const char *ext = strrchr(path, '.');
+    snprintf(golden_path, sizeof(golden_path), "%.*s.golden", (int)(ext ? ext - path : strlen(path)), path);
+
+    sim_init();
+    text_t output = {0};
+    text_append(&output, "# Generated by `make golden`. Reports as: <ms> <mods> | <keys>");
+    sim_set_report_hook(record_report, &output);
+    replay_once(&trace, NULL);
+    sim_set_report_hook(NULL, NULL);
+
+    char footer[128];
+    snprintf(footer, sizeof(footer), "# cost: events=%u records=%u reports_requested=%u reports_sent=%u", sim_stats.key_events, sim_stats.records, sim_stats.reports_requested, sim_stats.reports_sent);
+    text_append(&output, footer);
+
+    int status = 0;
+    if (update) {
+        FILE *file = fopen(golden_path, "w");
+        if (!file || fputs(output.data, file) < 0 || fclose(file) != 0) {
+            perror(golden_path);
+            return 2;
+        }
+        printf("%s: updated\n", golden_path);
+    } else {
+        char *golden = read_file(golden_path);
+        if (!golden) {
+            printf("%s: FAIL, missing %s (run `make golden`)\n", path, golden_path);
+            status = 1;
+        } else if (strcmp(golden, output.data) != 0) {
+            printf("%s: FAIL, report stream differs from %s\n", path, golden_path);
+            print_diff(golden_path, golden, output.data);
+            status = 1;
+        } else {
+            printf("%s: ok\n", path);
+        }
+        free(golden);
+    }
+
+    if (repeats && trace.count) {
+        uint64_t *costs = malloc(trace.count * sizeof(uint64_t));
+        for (size_t i = 0; i < trace.count; i++) {
+            costs[i] = UINT64_MAX;
+        }
+        uint64_t elapsed = 0;
+        for (uint32_t i = 0; i < repeats; i++) {
+            elapsed += replay_once(&trace, costs);
+        }
+        size_t   worst = 0;
+        uint64_t total = 0;
+        for (size_t i = 0; i < trace.count; i++) {
+            total += costs[i];
+            if (costs[i] > costs[worst]) {
+                worst = i;
+            }
+        }
+        printf("  %zu events, %.2f M events/s including scans, event cost mean %.0f ns, worst %llu ns (line %u)\n", trace.count, (double)trace.count * repeats / elapsed * 1e3, (double)total / trace.count, (unsigned long long)costs[worst], trace.events[worst].line);
+        free(costs);
+    }
+
+    free(output.data);
+    trace_free(&trace);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    bool     update  = false;
+    uint32_t repeats = 200;
+    int      opt;
+    while ((opt = getopt(argc, argv, "ur:")) != -1) {
+        switch (opt) {
+            case 'u':
+                update = true;
+                break;
+            case 'r':
+                repeats = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-u] [-r repeats] trace...\n", argv[0]);
+                return 2;
+        }
+    }
+
+    int failures = 0;
+    for (int i = optind; i < argc; i++) {
+        fflush(stdout);
+        const pid_t pid = fork();
+        if (pid == 0) {
+            exit(run_trace(argv[i], update, update ? 0 : repeats));
+        }
+        int status;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failures++;
+        }
+    }
+    if (failures) {
+        printf("%d of %d traces failed\n", failures, argc - optind);
+    }
+    return failures ? 1 : 0;
+}
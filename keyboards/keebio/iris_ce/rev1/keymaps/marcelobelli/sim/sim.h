@@ -0,0 +1,124 @@
+// Host simulator driver API.
+//
+// The simulator links keymap.c and the SRC from rules.mk against a mocked QMK
+// core (sim/qmk/quantum.h, sim/sim_core.c). Time comes from a virtual
+// millisecond clock that only moves when the driver advances it, so event
+// sequences replay deterministically and as fast as the host allows.
+//
+// Typical use:
+//
+//     sim_init();
+//     sim_set_report_hook(on_report, NULL);
+//     sim_key(pos, true);
+//     sim_advance(80);
+//     sim_key(pos, false);
+//     sim_advance(1000);
+
+#pragma once
+
+#include "quantum.h"
+
+typedef struct {
+    // QMK tap-hold settings, applied by the mocked action_tapping logic.
+    uint16_t tapping_term;
+    uint16_t quick_tap_term;
+    bool     permissive_hold;
+    bool     hold_on_other_key_press;
+    bool     chordal_hold;
+    // Milliseconds of virtual time between matrix scans.
+    uint16_t scan_interval;
+    // Whether sim_scan() steps the RGB Matrix task.
+    bool rgb_enabled;
+    // Value returned by rgb_matrix_get_val().
+    uint8_t rgb_val;
+} sim_config_t;
+
+typedef struct {
+    uint32_t key_events;         // Key events fed into the tap-hold logic.
+    uint32_t scans;              // Matrix scans.
+    uint32_t records;            // Calls to process_record().
+    uint32_t reports_requested;  // Calls to send_keyboard_report().
+    uint32_t reports_sent;       // Reports that reached the host.
+    uint32_t rgb_frames;         // Completed RGB Matrix frames.
+    uint32_t bootloader;         // QK_BOOT and EE_CLR presses.
+    uint32_t split_transactions; // User RPCs sent to the other half.
+    uint32_t led_writes;         // rgb_matrix_set_color() calls.
+} sim_stats_t;
+
+typedef struct {
+    uint32_t          time;
+    report_keyboard_t report;
+} sim_report_t;
+
+typedef void (*sim_report_hook_t)(const sim_report_t *report, void *ctx);
+
+typedef void (*sim_action_hook_t)(const keyrecord_t *record, action_t action, void *ctx);
+
+extern sim_config_t sim_config;
+extern sim_stats_t  sim_stats;
+
+/**
+ * Resets the clock, matrix, layers, mods, report and mocked tap-hold state.
+ *
+ * Feature state inside keymap.c and features/ is not reset. Call
+ * sim_quiesce() between sessions to let it return to idle instead.
+ */
+void sim_init(void);
+
+/** Current virtual time in milliseconds. */
+uint32_t sim_now(void);
+
+/** Runs one matrix scan at the current time. */
+void sim_scan(void);
+
+/**
+ * Virtual time the last scan started at. The clock can be past it by more
+ * than `scan_interval` after a scan blocked in wait_ms().
+ */
+uint32_t sim_last_scan(void);
+
+/** Advances virtual time by `ms`, scanning every `scan_interval`. */
+void sim_advance(uint32_t ms);
+
+/**
+ * Advances virtual time by `ms` without scanning, as if the main loop were
+ * blocked, then runs one scan.
+ */
+void sim_stall(uint32_t ms);
+
+/** Advances virtual time to `time`, if it is in the future. */
+void sim_advance_to(uint32_t time);
+
+/**
+ * Injects a matrix change for `key` at the current time. Events that don't
+ * change the matrix are ignored, like a real scan would.
+ */
+void sim_key(keypos_t key, bool pressed);
+
+/** Returns true if `key` is currently pressed in the simulated matrix. */
+bool sim_key_is_pressed(keypos_t key);
+
+/** Releases every pressed key and advances `idle_ms` to let timers expire. */
+void sim_quiesce(uint32_t idle_ms);
+
+/** Finds the first matrix position that has `keycode` on `layer`. */
+bool sim_find_key(uint8_t layer, uint16_t keycode, keypos_t *key);
+
+/** Calls `hook` for every report that reaches the host. NULL disables it. */
+void sim_set_report_hook(sim_report_hook_t hook, void *ctx);
+
+/**
+ * Calls `hook` for every process_action(), with the record as the action sees
+ * it (for a tap-hold action, `tap.count` > 0 means it runs as a tap). NULL
+ * disables it.
+ */
+void sim_set_action_hook(sim_action_hook_t hook, void *ctx);
+
+/** Returns true if `action` is a mod-tap or layer-tap action. */
+bool sim_is_tap_hold_action(action_t action);
+
+/** Returns the last report that reached the host. */
+const report_keyboard_t *sim_last_report(void);
+
+/** Returns the simulated LED buffer, RGB_MATRIX_LED_COUNT entries. */
+const RGB *sim_leds(void);
@@ -0,0 +1,1175 @@
+// Host simulator: mocked QMK core.
+//
+// Implements the subset of quantum/ declared in sim/qmk/quantum.h. The event
+// path follows QMK's: a matrix change becomes a keyevent_t, goes through the
+// tap-hold logic of action_tapping.c (modelled here with TAPPING_TERM and
+// TAPPING_TERM_PER_KEY, QUICK_TAP_TERM, PERMISSIVE_HOLD, HOLD_ON_OTHER_KEY_PRESS and CHORDAL_HOLD
+// with its default opposite hands rule), then through
+// process_record() -> process_record_user() -> process_action(), which
+// updates the mods, keys and layer state and sends keyboard reports.
+//
+// Simplifications: one tapping key is tracked at a time, media keys are
+// reported as regular keys, and of QMK's RGB effects only solid color and
+// breathing are rendered, next to the keymap's own (RGB_MATRIX_CUSTOM_USER).
+
+#include <string.h>
+#include "sim.h"
+#include "transactions.h"
+
+#ifndef PERMISSIVE_HOLD
+#    define SIM_PERMISSIVE_HOLD false
+#else
+#    define SIM_PERMISSIVE_HOLD true
+#endif
+#ifndef HOLD_ON_OTHER_KEY_PRESS
+#    define SIM_HOLD_ON_OTHER_KEY_PRESS false
+#else
+#    define SIM_HOLD_ON_OTHER_KEY_PRESS true
+#endif
+#ifndef CHORDAL_HOLD
+#    define SIM_CHORDAL_HOLD false
+#else
+#    define SIM_CHORDAL_HOLD true
+#endif
+#define WAITING_BUFFER_SIZE 8
+
+sim_config_t sim_config;
+sim_stats_t  sim_stats;
+bool         debug_enable = false;
+
+static uint32_t          sim_time;
+static uint32_t          last_scan;
+static uint8_t           matrix[MATRIX_ROWS][MATRIX_COLS];
+static sim_report_hook_t report_hook;
+static void             *report_hook_ctx;
+static sim_action_hook_t action_hook;
+static void             *action_hook_ctx;
+
+/* Timer. */
+
+uint16_t timer_read(void) {
+    return (uint16_t)sim_time;
+}
+
+uint32_t timer_read32(void) {
+    return sim_time;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return TIMER_DIFF_32(timer_read32(), last);
+}
+
+// Blocking waits stall the firmware: time passes without scanning.
+void wait_ms(uint16_t ms) {
+    sim_time += ms;
+}
+
+/* Layers. */
+
+layer_state_t layer_state         = 0;
+layer_state_t default_layer_state = 1;
+
+void layer_state_set(layer_state_t state) {
+    layer_state = layer_state_set_user(state);
+}
+
+bool layer_state_is(uint8_t layer) {
+    return layer_state & ((layer_state_t)1 << layer);
+}
+
+void layer_clear(void) {
+    layer_state_set(0);
+}
+
+void layer_move(uint8_t layer) {
+    layer_state_set((layer_state_t)1 << layer);
+}
+
+void layer_on(uint8_t layer) {
+    layer_state_set(layer_state | ((layer_state_t)1 << layer));
+}
+
+void layer_off(uint8_t layer) {
+    layer_state_set(layer_state & ~((layer_state_t)1 << layer));
+}
+
+void layer_invert(uint8_t layer) {
+    layer_state_set(layer_state ^ ((layer_state_t)1 << layer));
+}
+
+void layer_or(layer_state_t state) {
+    layer_state_set(layer_state | state);
+}
+
+void layer_and(layer_state_t state) {
+    layer_state_set(layer_state & state);
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+    return state ? 31 - __builtin_clz(state) : 0;
+}
+
+uint8_t get_oneshot_layer(void) {
+    return 0;
+}
+
+void reset_oneshot_layer(void) {}
+
+bool is_caps_word_on(void) {
+    return false;
+}
+
+/* Keymap and layer cache. */
+
+static uint8_t source_layers[MATRIX_ROWS][MATRIX_COLS];
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return pgm_read_word(&keymaps[layer][key.row][key.col]);
+}
+
+static uint8_t layer_switch_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    for (int8_t i = 31; i >= 0; i--) {
+        if ((layers & ((layer_state_t)1 << i)) && keymap_key_to_keycode(i, key) != KC_TRNS) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
+    uint8_t layer;
+    if (event.pressed) {
+        layer = layer_switch_get_layer(event.key);
+        if (update_layer_cache) {
+            source_layers[event.key.row][event.key.col] = layer;
+        }
+    } else {
+        layer = source_layers[event.key.row][event.key.col];
+    }
+    return keymap_key_to_keycode(layer, event.key);
+}
+
+uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
+    return get_event_keycode(record->event, update_layer_cache);
+}
+
+/* Mods and the keyboard report. */
+
+static report_keyboard_t report;
+static report_keyboard_t last_sent;
+static uint8_t           real_mods;
+static uint8_t           weak_mods;
+report_keyboard_t       *keyboard_report = &report;
+
+uint8_t get_mods(void) {
+    return real_mods;
+}
+
+void add_mods(uint8_t mods) {
+    real_mods |= mods;
+}
+
+void del_mods(uint8_t mods) {
+    real_mods &= ~mods;
+}
+
+void set_mods(uint8_t mods) {
+    real_mods = mods;
+}
+
+void clear_mods(void) {
+    real_mods = 0;
+}
+
+uint8_t get_weak_mods(void) {
+    return weak_mods;
+}
+
+void add_weak_mods(uint8_t mods) {
+    weak_mods |= mods;
+}
+
+void del_weak_mods(uint8_t mods) {
+    weak_mods &= ~mods;
+}
+
+void clear_weak_mods(void) {
+    weak_mods = 0;
+}
+
+// Converts a 5-bit MOD_ code to the 8-bit mod bits of the report.
+static uint8_t mod_5bit_to_8bit(uint8_t mods) {
+    return (mods & 0x10) ? (mods & 0xF) << 4 : (mods & 0xF);
+}
+
+void register_mods(uint8_t mods) {
+    if (mods) {
+        add_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+void unregister_mods(uint8_t mods) {
+    if (mods) {
+        del_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+uint8_t mod_config(uint8_t mod) {
+    return mod;
+}
+
+void add_key(uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report.keys[i] == key) {
+            return;
+        }
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report.keys[i] == KC_NO) {
+            report.keys[i] = key;
+            return;
+        }
+    }
+}
+
+void del_key(uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report.keys[i] == key) {
+            report.keys[i] = KC_NO;
+        }
+    }
+}
+
+void clear_keys(void) {
+    memset(report.keys, 0, sizeof(report.keys));
+}
+
+void clear_keyboard(void) {
+    clear_mods();
+    clear_weak_mods();
+    clear_keys();
+    send_keyboard_report();
+}
+
+// Like QMK's send_6kro_report(), only reports that differ from the last one
+// go to the host driver.
+void send_keyboard_report(void) {
+    sim_stats.reports_requested++;
+    report.mods = real_mods | weak_mods;
+    if (memcmp(&report, &last_sent, sizeof(report)) == 0) {
+        return;
+    }
+    last_sent = report;
+    host_keyboard_send(&report);
+}
+
+/* Host driver. */
+
+// What the host last received, which a driver the keymap installs over the
+// simulator's may hold back or leave out.
+static report_keyboard_t host_report;
+
+static uint8_t sim_keyboard_leds(void) {
+    return 0;
+}
+
+static void sim_send_keyboard(report_keyboard_t *sent) {
+    host_report = *sent;
+    sim_stats.reports_sent++;
+    if (report_hook) {
+        const sim_report_t hooked = {.time = sim_time, .report = *sent};
+        report_hook(&hooked, report_hook_ctx);
+    }
+}
+
+static host_driver_t  sim_driver  = {sim_keyboard_leds, sim_send_keyboard};
+static host_driver_t *host_driver = &sim_driver;
+
+host_driver_t *host_get_driver(void) {
+    return host_driver;
+}
+
+void host_set_driver(host_driver_t *driver) {
+    host_driver = driver;
+}
+
+void host_keyboard_send(report_keyboard_t *sent) {
+    if (host_driver) {
+        host_driver->send_keyboard(sent);
+    }
+}
+
+void register_code(uint8_t code) {
+    if (code == KC_NO) {
+        return;
+    }
+    if (IS_MODIFIER_KEYCODE(code)) {
+        add_mods(MOD_BIT(code));
+    } else {
+        add_key(code);
+    }
+    send_keyboard_report();
+}
+
+void unregister_code(uint8_t code) {
+    if (code == KC_NO) {
+        return;
+    }
+    if (IS_MODIFIER_KEYCODE(code)) {
+        del_mods(MOD_BIT(code));
+    } else {
+        del_key(code);
+    }
+    send_keyboard_report();
+}
+
+void tap_code(uint8_t code) {
+    register_code(code);
+    for (uint16_t i = code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY; i > 0; i--) {
+        wait_ms(1);
+    }
+    unregister_code(code);
+}
+
+void register_code16(uint16_t code) {
+    const uint8_t mods = mod_5bit_to_8bit(QK_MODS_GET_MODS(code));
+    if (mods) {
+        add_weak_mods(mods);
+        send_keyboard_report();
+    }
+    register_code(QK_MODS_GET_BASIC_KEYCODE(code));
+}
+
+void unregister_code16(uint16_t code) {
+    const uint8_t mods = mod_5bit_to_8bit(QK_MODS_GET_MODS(code));
+    unregister_code(QK_MODS_GET_BASIC_KEYCODE(code));
+    if (mods) {
+        del_weak_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+void tap_code16(uint16_t code) {
+    register_code16(code);
+    for (uint16_t i = TAP_CODE_DELAY; i > 0; i--) {
+        wait_ms(1);
+    }
+    unregister_code16(code);
+}
+
+/* Send String, US ANSI only. */
+
+void send_char(char ascii_code) {
+    if ((uint8_t)ascii_code >= sizeof(ascii_to_keycode_lut)) {
+        return;
+    }
+    const uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    const bool    shifted = (pgm_read_byte(&ascii_to_shift_lut[(uint8_t)ascii_code / 8]) >> (ascii_code % 8)) & 1;
+    if (shifted) {
+        register_code(KC_LEFT_SHIFT);
+    }
+    tap_code(keycode);
+    if (shifted) {
+        unregister_code(KC_LEFT_SHIFT);
+    }
+}
+
+void send_string(const char *string) {
+    while (*string) {
+        send_char(*string++);
+    }
+}
+
+/* Actions. */
+
+action_t action_for_keycode(uint16_t keycode) {
+    action_t action = {.code = ACTION_NO};
+    switch (keycode) {
+        case KC_A ... KC_RIGHT_GUI:
+            action.code = ACTION_KEY(keycode);
+            break;
+        case QK_MODS ... QK_MODS_MAX:
+            action.code = ACTION_MODS_KEY(QK_MODS_GET_MODS(keycode), QK_MODS_GET_BASIC_KEYCODE(keycode));
+            break;
+        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+            action.code = ACTION_MODS_TAP_KEY(QK_MOD_TAP_GET_MODS(keycode), QK_MOD_TAP_GET_TAP_KEYCODE(keycode));
+            break;
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            action.code = ACTION_LAYER_TAP_KEY(QK_LAYER_TAP_GET_LAYER(keycode), QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
+            break;
+        case QK_MOMENTARY ... QK_MOMENTARY_MAX:
+            action.code = ACTION_LAYER_MOMENTARY(QK_MOMENTARY_GET_LAYER(keycode));
+            break;
+    }
+    return action;
+}
+
+void process_action(keyrecord_t *record, action_t action) {
+    const bool    pressed   = record->event.pressed;
+    const uint8_t tap_count = record->tap.count;
+    const uint8_t kind      = action.code >> 12;
+    const uint8_t code      = action.code & 0xFF;
+    const uint8_t param     = (action.code >> 8) & 0xF;
+
+    if (action_hook) {
+        action_hook(record, action, action_hook_ctx);
+    }
+    switch (kind) {
+        case ACT_LMODS:
+        case ACT_RMODS: {
+            const uint8_t mods = (kind == ACT_LMODS) ? param : param << 4;
+            if (pressed) {
+                if (mods) {
+                    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+                        add_mods(mods);
+                    } else {
+                        add_weak_mods(mods);
+                    }
+                    send_keyboard_report();
+                }
+                register_code(code);
+            } else {
+                unregister_code(code);
+                if (mods) {
+                    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+                        del_mods(mods);
+                    } else {
+                        del_weak_mods(mods);
+                    }
+                    send_keyboard_report();
+                }
+            }
+        } break;
+
+        case ACT_LMODS_TAP:
+        case ACT_RMODS_TAP: {
+            const uint8_t mods = (kind == ACT_LMODS_TAP) ? param : param << 4;
+            if (pressed) {
+                if (tap_count > 0) {
+                    register_code(code);
+                } else {
+                    register_mods(mods);
+                }
+            } else {
+                if (tap_count > 0) {
+                    wait_ms(code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+                    unregister_code(code);
+                } else {
+                    unregister_mods(mods);
+                }
+            }
+        } break;
+
+        case ACT_LAYER_TAP:
+        case ACT_LAYER_TAP_EXT:
+            if (code == OP_ON_OFF) {
+                pressed ? layer_on(param) : layer_off(param);
+            } else if (pressed) {
+                tap_count > 0 ? register_code(code) : layer_on(param);
+            } else if (tap_count > 0) {
+                wait_ms(code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+                unregister_code(code);
+            } else {
+                layer_off(param);
+            }
+            break;
+    }
+}
+
+static bool process_record_quantum(keyrecord_t *record) {
+    const uint16_t keycode = get_record_keycode(record, true);
+    if (!process_record_user(keycode, record)) {
+        return false;
+    }
+    switch (keycode) {
+        case QK_BOOT:
+        case EE_CLR:
+            if (record->event.pressed) {
+                sim_stats.bootloader++;
+            }
+            return false;
+    }
+    return true;
+}
+
+void process_record(keyrecord_t *record) {
+    if (IS_NOEVENT(record->event)) {
+        return;
+    }
+    sim_stats.records++;
+    if (!process_record_quantum(record)) {
+        return;
+    }
+    process_action(record, action_for_keycode(get_record_keycode(record, false)));
+}
+
+/* Tap-hold, after action_tapping.c. */
+
+static keyrecord_t tapping_key;
+static bool        tapping_active;
+static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE];
+static uint8_t     waiting_count;
+static uint8_t     tap_counts[MATRIX_ROWS][MATRIX_COLS];
+// Last tap, for QUICK_TAP_TERM repeats. Cleared by any other key press.
+static keyrecord_t last_tap;
+static bool        last_tap_valid;
+
+static bool is_tap_record(keyrecord_t *record) {
+    const uint16_t keycode = get_event_keycode(record->event, false);
+    return IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
+}
+
+static bool same_key(keypos_t a, keypos_t b) {
+    return a.row == b.row && a.col == b.col;
+}
+
+static bool waiting_buffer_has_press(keypos_t key) {
+    for (uint8_t i = 0; i < waiting_count; i++) {
+        if (waiting_buffer[i].event.pressed && same_key(waiting_buffer[i].event.key, key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void waiting_buffer_enq(keyrecord_t *record) {
+    if (waiting_count < WAITING_BUFFER_SIZE) {
+        waiting_buffer[waiting_count++] = *record;
+        return;
+    }
+    // Overflow: like QMK, drop the buffered events and clear all state.
+    clear_keyboard();
+    memset(tap_counts, 0, sizeof(tap_counts));
+    waiting_count  = 0;
+    tapping_active = false;
+}
+
+static void tapping_process(keyrecord_t *record);
+
+static void waiting_buffer_flush(void) {
+    keyrecord_t   pending[WAITING_BUFFER_SIZE];
+    const uint8_t count = waiting_count;
+    memcpy(pending, waiting_buffer, sizeof(keyrecord_t) * count);
+    waiting_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        tapping_process(&pending[i]);
+    }
+}
+
+static void settle_tapping_key_as_hold(void) {
+    const keypos_t key           = tapping_key.event.key;
+    tapping_active               = false;
+    tapping_key.tap.count        = 0;
+    tap_counts[key.row][key.col] = 0;
+    process_record(&tapping_key);
+    waiting_buffer_flush();
+}
+
+static void settle_tapping_key_as_tap(void) {
+    const keypos_t key           = tapping_key.event.key;
+    tapping_active               = false;
+    tapping_key.tap.count        = 1;
+    tap_counts[key.row][key.col] = 1;
+    process_record(&tapping_key);
+    waiting_buffer_flush();
+}
+
+// Chordal Hold's default rule: the two halves of the split are the two hands.
+static bool same_hand(keypos_t a, keypos_t b) {
+    return (a.row < MATRIX_ROWS / 2) == (b.row < MATRIX_ROWS / 2);
+}
+
+// True if every buffered event is a tap-hold press on the tapping key's hand,
+// i.e. a same-hand mod chord still being built.
+static bool waiting_buffer_is_same_hand_chord(void) {
+    for (uint8_t i = 0; i < waiting_count; i++) {
+        if (!waiting_buffer[i].event.pressed || !is_tap_record(&waiting_buffer[i]) || !same_hand(waiting_buffer[i].event.key, tapping_key.event.key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Handles an event when no tapping key is being decided.
+static void process_key_event(keyrecord_t *record) {
+    keyevent_t *event = &record->event;
+    if (event->pressed) {
+        if (is_tap_record(record)) {
+            if (last_tap_valid && same_key(last_tap.event.key, event->key) && TIMER_DIFF_16(event->time, last_tap.event.time) < sim_config.quick_tap_term) {
+                // Quick tap: repeat the tap without deciding again.
+                record->tap.count = last_tap.tap.count < 15 ? last_tap.tap.count + 1 : 15;
+                tap_counts[event->key.row][event->key.col] = record->tap.count;
+                last_tap_valid                             = false;
+                process_record(record);
+                return;
+            }
+            tapping_key    = *record;
+            tapping_active = true;
+            last_tap_valid = false;
+            return;
+        }
+        last_tap_valid = false;
+    } else {
+        record->tap.count                          = tap_counts[event->key.row][event->key.col];
+        tap_counts[event->key.row][event->key.col] = 0;
+        if (record->tap.count > 0) {
+            last_tap       = *record;
+            last_tap_valid = true;
+        }
+    }
+    process_record(record);
+}
+
+static void tapping_process(keyrecord_t *record) {
+    if (!tapping_active) {
+        process_key_event(record);
+        return;
+    }
+
+    const keyevent_t *event = &record->event;
+    if (same_key(event->key, tapping_key.event.key)) {
+        if (!event->pressed) { // Released within the tapping term: a tap.
+            tapping_active        = false;
+            tapping_key.tap.count = 1;
+            process_record(&tapping_key);
+            tap_counts[event->key.row][event->key.col] = 1;
+            waiting_buffer_enq(record);
+            waiting_buffer_flush();
+        }
+        return;
+    }
+
+    if (event->pressed) {
+        tapping_key.tap.interrupted = true;
+        if (sim_config.chordal_hold && same_hand(tapping_key.event.key, event->key) && waiting_buffer_is_same_hand_chord()) {
+            if (is_tap_record(record)) {
+                // Possibly more mods on the same hand, decided together by
+                // the next key.
+                waiting_buffer_enq(record);
+            } else {
+                // Same-hand chord: settle as tapped right away.
+                settle_tapping_key_as_tap();
+                tapping_process(record);
+            }
+        } else if (sim_config.hold_on_other_key_press) {
+            settle_tapping_key_as_hold();
+            tapping_process(record);
+        } else {
+            waiting_buffer_enq(record);
+        }
+    } else if (waiting_buffer_has_press(event->key)) {
+        if (sim_config.permissive_hold) {
+            settle_tapping_key_as_hold();
+            tapping_process(record);
+        } else {
+            waiting_buffer_enq(record);
+        }
+    } else { // Release of a key pressed before the tapping key.
+        process_key_event(record);
+    }
+}
+
+// The tapping key's term, as GET_TAPPING_TERM() in action_tapping.c.
+static uint16_t tapping_term(void) {
+#ifdef TAPPING_TERM_PER_KEY
+    return get_tapping_term(get_record_keycode(&tapping_key, false), &tapping_key);
+#else
+    return sim_config.tapping_term;
+#endif
+}
+
+static void tapping_check_timeout(uint16_t time) {
+    if (tapping_active && TIMER_DIFF_16(time, tapping_key.event.time) >= tapping_term()) {
+        settle_tapping_key_as_hold();
+    }
+}
+
+static void action_exec(keyevent_t event) {
+    tapping_check_timeout(event.time);
+    if (IS_KEYEVENT(event)) {
+        sim_stats.key_events++;
+        keyrecord_t record = {.event = event};
+        // As in action_exec(), before tap-hold handling sees the event.
+        if (pre_process_record_user(get_record_keycode(&record, true), &record)) {
+            tapping_process(&record);
+        }
+    }
+}
+
+/* RGB Matrix. */
+
+led_config_t g_led_config = {
+    .matrix_co = IRIS_MATRIX(NO_LED, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55),
+    // 56 per-key LEDs, then underglow.
+    .flags = {[0 ... 55] = LED_FLAG_KEYLIGHT, [56 ... RGB_MATRIX_LED_COUNT - 1] = LED_FLAG_UNDERGLOW},
+};
+
+rgb_config_t rgb_matrix_config;
+uint32_t     g_rgb_timer;
+
+static RGB      leds[RGB_MATRIX_LED_COUNT];
+static uint8_t  rgb_iter;
+static uint8_t  rgb_last_mode;
+static uint16_t rgb_frame_timer;
+
+RGB hsv_to_rgb(HSV hsv) {
+    RGB rgb;
+    if (hsv.s == 0) {
+        rgb.r = rgb.g = rgb.b = hsv.v;
+        return rgb;
+    }
+    const uint8_t  h         = hsv.h;
+    const uint8_t  s         = hsv.s;
+    const uint8_t  v         = hsv.v;
+    const uint8_t  region    = h * 6 / 255;
+    const uint16_t remainder = (h * 2 - region * 85) * 3;
+    const uint8_t  p         = (v * (255 - s)) >> 8;
+    const uint8_t  q         = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    const uint8_t  t         = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+    switch (region) {
+        case 6:
+        case 0:
+            rgb = (RGB){v, t, p};
+            break;
+        case 1:
+            rgb = (RGB){q, v, p};
+            break;
+        case 2:
+            rgb = (RGB){p, v, t};
+            break;
+        case 3:
+            rgb = (RGB){p, q, v};
+            break;
+        case 4:
+            rgb = (RGB){t, p, v};
+            break;
+        default:
+            rgb = (RGB){v, p, q};
+            break;
+    }
+    return rgb;
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    sim_stats.led_writes++;
+    if (index >= 0 && index < RGB_MATRIX_LED_COUNT) {
+        leds[index] = (RGB){red, green, blue};
+    }
+}
+
+void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        leds[i] = (RGB){red, green, blue};
+    }
+}
+
+void rgb_matrix_sethsv_noeeprom(uint16_t hue, uint8_t sat, uint8_t val) {
+    rgb_matrix_config.hsv = (HSV){hue, sat, val};
+}
+
+void rgb_matrix_sethsv(uint16_t hue, uint8_t sat, uint8_t val) {
+    rgb_matrix_sethsv_noeeprom(hue, sat, val);
+}
+
+uint8_t rgb_matrix_get_val(void) {
+    return sim_config.rgb_val;
+}
+
+bool rgb_matrix_check_finished_leds(uint8_t led_idx) {
+    return led_idx < RGB_MATRIX_LED_COUNT;
+}
+
+static bool SOLID_COLOR(effect_params_t *params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    const RGB rgb = rgb_matrix_hsv_to_rgb(rgb_matrix_config.hsv);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+    }
+    return rgb_matrix_check_finished_leds(led_max);
+}
+
+// As quantum/rgb_matrix/animations/breathing_anim.h.
+static bool BREATHING(effect_params_t *params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    HSV      hsv  = rgb_matrix_config.hsv;
+    uint16_t time = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 8);
+    hsv.v         = scale8(abs8(sin8(time) - 128) * 2, hsv.v);
+    RGB rgb       = rgb_matrix_hsv_to_rgb(hsv);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+    }
+    return rgb_matrix_check_finished_leds(led_max);
+}
+
+#ifdef RGB_MATRIX_CUSTOM_USER
+#    define RGB_MATRIX_EFFECT(name)
+#    define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#    include "rgb_matrix_user.inc"
+#    undef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#    undef RGB_MATRIX_EFFECT
+#endif
+
+static void rgb_matrix_render(effect_params_t *params) {
+    switch (rgb_matrix_config.mode) {
+        case RGB_MATRIX_NONE:
+            break;
+        case RGB_MATRIX_BREATHING:
+            BREATHING(params);
+            break;
+#ifdef RGB_MATRIX_CUSTOM_USER
+#    define RGB_MATRIX_EFFECT(name)  \
+        case RGB_MATRIX_CUSTOM_##name: \
+            name(params);            \
+            break;
+#    include "rgb_matrix_user.inc"
+#    undef RGB_MATRIX_EFFECT
+#endif
+        default:
+            SOLID_COLOR(params);
+            break;
+    }
+}
+
+// One step of rgb_matrix_task(): render the effect and run the indicators for
+// one chunk of RGB_MATRIX_LED_PROCESS_LIMIT LEDs per scan, then wait out
+// RGB_MATRIX_LED_FLUSH_LIMIT before starting the next frame.
+static void rgb_matrix_task(void) {
+    if (rgb_iter == 0) {
+        if (TIMER_DIFF_16(timer_read(), rgb_frame_timer) < RGB_MATRIX_LED_FLUSH_LIMIT) {
+            return;
+        }
+        rgb_frame_timer = timer_read();
+        g_rgb_timer     = timer_read32();
+    }
+    const uint8_t led_min = RGB_MATRIX_LED_PROCESS_LIMIT * rgb_iter;
+    uint8_t       led_max = led_min + RGB_MATRIX_LED_PROCESS_LIMIT;
+    if (led_max > RGB_MATRIX_LED_COUNT) {
+        led_max = RGB_MATRIX_LED_COUNT;
+    }
+    effect_params_t params = {.iter = rgb_iter, .flags = rgb_matrix_config.flags, .init = rgb_matrix_config.mode != rgb_last_mode};
+    rgb_matrix_render(&params);
+    rgb_last_mode = rgb_matrix_config.mode;
+    rgb_matrix_indicators_advanced_user(led_min, led_max);
+    if (led_max == RGB_MATRIX_LED_COUNT) {
+        rgb_iter = 0;
+        sim_stats.rgb_frames++;
+    } else {
+        rgb_iter++;
+    }
+}
+
+/* Deferred execution, as in QMK's deferred_exec.c. */
+
+#ifdef DEFERRED_EXEC_ENABLE
+typedef struct {
+    deferred_token         token;
+    uint32_t               trigger_time;
+    deferred_exec_callback callback;
+    void                  *cb_arg;
+} deferred_executor_t;
+
+static deferred_executor_t executors[MAX_DEFERRED_EXECUTORS];
+static deferred_token      next_token = INVALID_DEFERRED_TOKEN + 1;
+static uint32_t            last_deferred_exec_check;
+// No executor triggers before this, so scans with nothing due skip the loop.
+static uint32_t next_trigger_time;
+static bool     have_next_trigger;
+
+static void note_trigger_time(uint32_t trigger_time) {
+    if (!have_next_trigger || (int32_t)(trigger_time - next_trigger_time) < 0) {
+        next_trigger_time = trigger_time;
+        have_next_trigger = true;
+    }
+}
+
+static deferred_executor_t *find_executor(deferred_token token) {
+    if (token == INVALID_DEFERRED_TOKEN) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        if (executors[i].token == token) {
+            return &executors[i];
+        }
+    }
+    return NULL;
+}
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
+    if (delay_ms == 0 || !callback) {
+        return INVALID_DEFERRED_TOKEN;
+    }
+    for (uint8_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        deferred_executor_t *entry = &executors[i];
+        if (entry->token == INVALID_DEFERRED_TOKEN) {
+            // Skip the invalid token as the counter wraps.
+            if (++next_token == INVALID_DEFERRED_TOKEN) {
+                ++next_token;
+            }
+            *entry = (deferred_executor_t){
+                .token        = next_token,
+                .trigger_time = timer_read32() + delay_ms,
+                .callback     = callback,
+                .cb_arg       = cb_arg,
+            };
+            note_trigger_time(entry->trigger_time);
+            return entry->token;
+        }
+    }
+    return INVALID_DEFERRED_TOKEN;
+}
+
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
+    deferred_executor_t *entry = find_executor(token);
+    if (delay_ms == 0 || !entry) {
+        return false;
+    }
+    entry->trigger_time = timer_read32() + delay_ms;
+    note_trigger_time(entry->trigger_time);
+    return true;
+}
+
+bool cancel_deferred_exec(deferred_token token) {
+    deferred_executor_t *entry = find_executor(token);
+    if (!entry) {
+        return false;
+    }
+    *entry = (deferred_executor_t){0};
+    return true;
+}
+
+// QMK runs due callbacks from keyboard_task(), at most once per ms. A callback
+// returning 0 is done; otherwise it runs again that many ms after its trigger.
+void deferred_exec_task(void) {
+    const uint32_t now = timer_read32();
+    if (now == last_deferred_exec_check) {
+        return;
+    }
+    last_deferred_exec_check = now;
+    if (!have_next_trigger || (int32_t)(next_trigger_time - now) > 0) {
+        return;
+    }
+    have_next_trigger = false;
+    for (uint8_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        deferred_executor_t *entry = &executors[i];
+        if (entry->token == INVALID_DEFERRED_TOKEN) {
+            continue;
+        }
+        if ((int32_t)(entry->trigger_time - now) > 0) {
+            note_trigger_time(entry->trigger_time);
+            continue;
+        }
+        const deferred_token token = entry->token;
+        const uint32_t       delay = entry->callback(entry->trigger_time, entry->cb_arg);
+        // The callback may have cancelled itself.
+        if (entry->token != token) {
+            continue;
+        }
+        if (delay == 0) {
+            *entry = (deferred_executor_t){0};
+        } else {
+            entry->trigger_time += delay;
+            note_trigger_time(entry->trigger_time);
+        }
+    }
+}
+#endif
+
+/* Split transport. */
+
+static slave_callback_t rpc_handlers[NUM_TOTAL_TRANSACTIONS];
+
+bool is_keyboard_master(void) {
+    return true;
+}
+
+void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback) {
+    if (transaction_id >= 0 && transaction_id < NUM_TOTAL_TRANSACTIONS) {
+        rpc_handlers[transaction_id] = callback;
+    }
+}
+
+bool transaction_rpc_send(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer) {
+    if (transaction_id < 0 || transaction_id >= NUM_TOTAL_TRANSACTIONS || !rpc_handlers[transaction_id]) {
+        return false;
+    }
+    sim_stats.split_transactions++;
+    rpc_handlers[transaction_id](initiator2target_buffer_size, initiator2target_buffer, 0, NULL);
+    return true;
+}
+
+/* Driver. */
+
+void sim_init(void) {
+    sim_config = (sim_config_t){
+        .tapping_term            = TAPPING_TERM,
+        .quick_tap_term          = QUICK_TAP_TERM,
+        .permissive_hold         = SIM_PERMISSIVE_HOLD,
+        .hold_on_other_key_press = SIM_HOLD_ON_OTHER_KEY_PRESS,
+        .chordal_hold            = SIM_CHORDAL_HOLD,
+        .scan_interval           = 1,
+        .rgb_enabled             = true,
+        .rgb_val                 = 255,
+    };
+    sim_stats = (sim_stats_t){0};
+    sim_time  = 0;
+    last_scan = 0;
+    memset(matrix, 0, sizeof(matrix));
+    memset(source_layers, 0, sizeof(source_layers));
+    memset(tap_counts, 0, sizeof(tap_counts));
+    memset(&report, 0, sizeof(report));
+    memset(&last_sent, 0, sizeof(last_sent));
+    memset(&host_report, 0, sizeof(host_report));
+    memset(leds, 0, sizeof(leds));
+    real_mods = weak_mods = 0;
+    layer_state           = 0;
+    default_layer_state   = 1;
+    tapping_active        = false;
+    waiting_count         = 0;
+    last_tap_valid        = false;
+    rgb_iter              = 0;
+    rgb_frame_timer       = 0;
+    rgb_last_mode         = RGB_MATRIX_NONE;
+    rgb_matrix_config     = (rgb_config_t){
+            .mode  = RGB_MATRIX_DEFAULT_MODE,
+            .hsv   = {0, 255, 255},
+            .speed = RGB_MATRIX_DEFAULT_SPD,
+            .flags = LED_FLAG_ALL,
+    };
+    g_rgb_timer = 0;
+#ifdef DEFERRED_EXEC_ENABLE
+    // next_token keeps counting, as on the board, so a token kept from before
+    // doesn't name a new executor.
+    memset(executors, 0, sizeof(executors));
+    last_deferred_exec_check = 0;
+    have_next_trigger        = false;
+#endif
+    report_hook           = NULL;
+    action_hook           = NULL;
+    // As in QMK, where protocol_post_init() sets the driver after
+    // keyboard_post_init_user().
+    host_driver = NULL;
+    keyboard_post_init_user();
+    host_driver = &sim_driver;
+}
+
+uint32_t sim_now(void) {
+    return sim_time;
+}
+
+uint32_t sim_last_scan(void) {
+    return last_scan;
+}
+
+void sim_scan(void) {
+    sim_stats.scans++;
+    last_scan = sim_time;
+    action_exec((keyevent_t){.type = TICK_EVENT, .time = timer_read() | 1});
+    matrix_scan_user();
+#ifdef DEFERRED_EXEC_ENABLE
+    deferred_exec_task();
+#endif
+    if (sim_config.rgb_enabled) {
+        rgb_matrix_task();
+    }
+    housekeeping_task_user();
+}
+
+void sim_advance_to(uint32_t time) {
+    const uint32_t interval = sim_config.scan_interval ? sim_config.scan_interval : 1;
+    while ((int32_t)(time - (last_scan + interval)) >= 0) {
+        // A scan that blocked in wait_ms() past the next one's start delays
+        // it, rather than turning the clock back.
+        if ((int32_t)(sim_time - (last_scan + interval)) < 0) {
+            sim_time = last_scan + interval;
+        }
+        sim_scan();
+    }
+    if ((int32_t)(time - sim_time) > 0) {
+        sim_time = time;
+    }
+}
+
+void sim_advance(uint32_t ms) {
+    sim_advance_to(sim_time + ms);
+}
+
+void sim_stall(uint32_t ms) {
+    sim_time += ms;
+    sim_scan();
+}
+
+void sim_key(keypos_t key, bool pressed) {
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS || matrix[key.row][key.col] == pressed) {
+        return;
+    }
+    matrix[key.row][key.col] = pressed;
+    action_exec((keyevent_t){.key = key, .pressed = pressed, .type = KEY_EVENT, .time = timer_read() | 1});
+    // QMK handles a matrix change within a scan and runs the housekeeping
+    // task at the end of it.
+    housekeeping_task_user();
+}
+
+bool sim_key_is_pressed(keypos_t key) {
+    return matrix[key.row][key.col];
+}
+
+void sim_quiesce(uint32_t idle_ms) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            sim_key((keypos_t){.col = col, .row = row}, false);
+        }
+    }
+    sim_advance(idle_ms);
+}
+
+bool sim_find_key(uint8_t layer, uint16_t keycode, keypos_t *key) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            const keypos_t pos = {.col = col, .row = row};
+            if (keymap_key_to_keycode(layer, pos) == keycode) {
+                *key = pos;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void sim_set_report_hook(sim_report_hook_t hook, void *ctx) {
+    report_hook     = hook;
+    report_hook_ctx = ctx;
+}
+
+void sim_set_action_hook(sim_action_hook_t hook, void *ctx) {
+    action_hook     = hook;
+    action_hook_ctx = ctx;
+}
+
+bool sim_is_tap_hold_action(action_t action) {
+    switch (action.code >> 12) {
+        case ACT_LMODS_TAP:
+        case ACT_RMODS_TAP:
+            return true;
+        case ACT_LAYER_TAP:
+        case ACT_LAYER_TAP_EXT:
+            return (action.code & 0xFF) != OP_ON_OFF;
+    }
+    return false;
+}
+
+const report_keyboard_t *sim_last_report(void) {
+    return &host_report;
+}
+
+const RGB *sim_leds(void) {
+    return leds;
+}
@@ -0,0 +1,32 @@
+// Host simulator: weak defaults for the user hooks the mocked core calls.
+//
+// Kept out of sim_core.o so that its calls to the hooks stay undefined there
+// and resolve at link time, where the linker's --wrap can reach them.
+
+#include "sim.h"
+
+__attribute__((weak)) layer_state_t layer_state_set_user(layer_state_t state) {
+    return state;
+}
+
+__attribute__((weak)) bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+__attribute__((weak)) bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+__attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return sim_config.tapping_term;
+}
+
+__attribute__((weak)) void matrix_scan_user(void) {}
+
+__attribute__((weak)) void housekeeping_task_user(void) {}
+
+__attribute__((weak)) void keyboard_post_init_user(void) {}
+
+__attribute__((weak)) bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    return true;
+}
@@ -0,0 +1,374 @@
+// Host simulator: tap-hold parameter sweep.
+//
+// Replays traces through the keymap under every combination of the settings
+// below and scores each one against the `tap`/`hold` intent annotations in the
+// traces (see trace.h):
+//
+//     ./build/sweep [-j jobs] [-n rows] [-t terms] [-a timeouts] [-s streaks]
+//                   [-p 0,1] [-e policies] traces...
+//
+//   -t  TAPPING_TERM values (default 150,175,200,250)
+//   -a  achordion_timeout() values, for the keys where keymap.c returns
+//       nonzero (default 500,800,1000,1500)
+//   -s  achordion_streak_timeout() values, 0 disables streaks
+//       (default 0,100,150,200,250)
+//   -p  PERMISSIVE_HOLD off/on (default 0,1)
+//   -e  achordion_eager_mod() policies: default (Shift, Ctrl), none, shift,
+//       all (default: all four)
+//   -j  worker processes (default: one per core)
+//   -n  rows to print, best first (default 20)
+//
+// A misfire is an annotated press whose tap-hold decision differs from the
+// intent. Latency is the time from a physical press to the last action it
+// produced, over all presses: how long the typist waits for the key to take
+// effect. The first row is the configuration keymap.c builds with.
+//
+// The firmware keeps its state in statics, so each worker is a forked process
+// with its own simulator; configurations are dealt round-robin to workers.
+// The achordion callbacks are overridden here. keymap.c's achordion_timeout()
+// is renamed to __real_achordion_timeout() at build time (see the Makefile),
+// so its per-key zeros still apply; the weak defaults are simply replaced.
+// get_tapping_term() is renamed the same way, so that its per-key terms apply
+// around the swept TAPPING_TERM.
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "features/achordion.h"
+#include "press_log.h"
+#include "trace_bin.h"
+
+#define MAX_VALUES 16
+#define MAX_JOBS 256
+#define IDLE_AFTER_TRACE 2000
+#define ACHORDION_DEFAULT_STREAK_TIMEOUT 200
+
+enum { EAGER_DEFAULT, EAGER_NONE, EAGER_SHIFT, EAGER_ALL, EAGER_POLICIES };
+
+static const char *const eager_names[EAGER_POLICIES] = {"default", "none", "shift", "all"};
+
+typedef struct {
+    bool     keymap; // Use keymap.c's own achordion_timeout() values.
+    uint16_t tapping_term;
+    uint16_t achordion_timeout;
+    uint16_t streak_timeout;
+    bool     permissive_hold;
+    uint8_t  eager;
+} sweep_config_t;
+
+typedef struct {
+    uint32_t index;
+    uint32_t scored;      // Presses with an intent annotation.
+    uint32_t tap_as_hold; // Meant as a tap, came out held.
+    uint32_t hold_as_tap; // Meant as a hold, came out tapped.
+    uint32_t samples;
+    uint32_t p50, p90, p99, max;
+} sweep_result_t;
+
+static sweep_config_t current;
+
+/* Achordion overrides. */
+
+uint16_t __real_achordion_timeout(uint16_t tap_hold_keycode);
+
+uint16_t achordion_timeout(uint16_t tap_hold_keycode) {
+    const uint16_t timeout = __real_achordion_timeout(tap_hold_keycode);
+    return (current.keymap || timeout == 0) ? timeout : current.achordion_timeout;
+}
+
+uint16_t __real_get_tapping_term(uint16_t keycode, keyrecord_t *record);
+
+// keymap.c's tapping term, with the swept one in place of TAPPING_TERM.
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    const uint16_t term = __real_get_tapping_term(keycode, record);
+    return term == TAPPING_TERM ? sim_config.tapping_term : term;
+}
+
+uint16_t achordion_streak_timeout(uint16_t tap_hold_keycode) {
+    return current.streak_timeout;
+}
+
+bool achordion_eager_mod(uint8_t mod) {
+    switch (current.eager) {
+        case EAGER_NONE:
+            return false;
+        case EAGER_SHIFT:
+            return (mod & (MOD_LCTL | MOD_LALT | MOD_LGUI)) == 0;
+        case EAGER_ALL:
+            return true;
+    }
+    return (mod & (MOD_LALT | MOD_LGUI)) == 0;
+}
+
+/* Scoring. */
+
+static press_log_t press_log;
+
+static int compare_u32(const void *a, const void *b) {
+    const uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static sweep_result_t run_config(uint32_t index, const sweep_config_t *config, const trace_t *traces, int trace_count) {
+    current = *config;
+    sim_init();
+    sim_config.tapping_term    = config->tapping_term;
+    sim_config.permissive_hold = config->permissive_hold;
+    sim_config.rgb_enabled     = false;
+    press_log_attach(&press_log);
+
+    for (int t = 0; t < trace_count; t++) {
+        press_log_start_trace(&press_log);
+        const uint32_t start = sim_now();
+        for (size_t i = 0; i < traces[t].count; i++) {
+            sim_advance_to(start + traces[t].events[i].time);
+            press_log_key(&press_log, &traces[t].events[i]);
+        }
+        sim_quiesce(IDLE_AFTER_TRACE);
+    }
+
+    sweep_result_t result    = {.index = index};
+    uint32_t      *latencies = malloc((press_log.count + 1) * sizeof(uint32_t));
+    if (!latencies) {
+        perror("malloc");
+        exit(1);
+    }
+    for (size_t i = 0; i < press_log.count; i++) {
+        const press_t *press = &press_log.presses[i];
+        if (press->acted) {
+            latencies[result.samples++] = press_latency(press);
+        }
+        if (press->intent != TRACE_INTENT_NONE) {
+            result.scored++;
+        }
+        if (press_is_misfire(press)) {
+            press->intent == TRACE_INTENT_TAP ? result.tap_as_hold++ : result.hold_as_tap++;
+        }
+    }
+    if (result.samples) {
+        qsort(latencies, result.samples, sizeof(uint32_t), compare_u32);
+        result.p50 = latencies[result.samples * 50 / 100];
+        result.p90 = latencies[result.samples * 90 / 100];
+        result.p99 = latencies[result.samples * 99 / 100];
+        result.max = latencies[result.samples - 1];
+    }
+    free(latencies);
+    return result;
+}
+
+/* Grid and workers. */
+
+typedef struct {
+    uint16_t values[MAX_VALUES];
+    int      count;
+} value_list_t;
+
+static bool parse_list(const char *arg, value_list_t *list) {
+    char  buf[256];
+    char *save;
+    snprintf(buf, sizeof(buf), "%s", arg);
+    list->count = 0;
+    for (char *token = strtok_r(buf, ",", &save); token; token = strtok_r(NULL, ",", &save)) {
+        char         *end;
+        unsigned long value = strtoul(token, &end, 10);
+        if (*end || value > UINT16_MAX || list->count == MAX_VALUES) {
+            return false;
+        }
+        list->values[list->count++] = value;
+    }
+    return list->count > 0;
+}
+
+static bool parse_eager(const char *arg, value_list_t *list) {
+    char  buf[256];
+    char *save;
+    snprintf(buf, sizeof(buf), "%s", arg);
+    list->count = 0;
+    for (char *token = strtok_r(buf, ",", &save); token; token = strtok_r(NULL, ",", &save)) {
+        int policy = 0;
+        while (policy < EAGER_POLICIES && strcmp(token, eager_names[policy]) != 0) {
+            policy++;
+        }
+        if (policy == EAGER_POLICIES || list->count == MAX_VALUES) {
+            return false;
+        }
+        list->values[list->count++] = policy;
+    }
+    return list->count > 0;
+}
+
+static double misfire_rate(const sweep_result_t *r) {
+    return r->scored ? (double)(r->tap_as_hold + r->hold_as_tap) / r->scored : 0;
+}
+
+static int compare_results(const void *a, const void *b) {
+    const sweep_result_t *x = a, *y = b;
+    const double          mx = misfire_rate(x), my = misfire_rate(y);
+    if (mx != my) {
+        return mx < my ? -1 : 1;
+    }
+    if (x->p90 != y->p90) {
+        return x->p90 < y->p90 ? -1 : 1;
+    }
+    if (x->p99 != y->p99) {
+        return x->p99 < y->p99 ? -1 : 1;
+    }
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+static void print_row(const sweep_config_t *c, const sweep_result_t *r) {
+    char timeout[16];
+    if (c->keymap) {
+        snprintf(timeout, sizeof(timeout), "keymap");
+    } else {
+        snprintf(timeout, sizeof(timeout), "%u", c->achordion_timeout);
+    }
+    printf("%5u %7s %6u %4s %-7s  %4u %4u %6.2f%%  %5u %5u %5u %5u\n", c->tapping_term, timeout, c->streak_timeout, c->permissive_hold ? "on" : "off", eager_names[c->eager], r->tap_as_hold, r->hold_as_tap, 100 * misfire_rate(r), r->p50, r->p90, r->p99, r->max);
+}
+
+int main(int argc, char **argv) {
+    value_list_t terms, timeouts, streaks, permissive, eager;
+    parse_list("150,175,200,250", &terms);
+    parse_list("500,800,1000,1500", &timeouts);
+    parse_list("0,100,150,200,250", &streaks);
+    parse_list("0,1", &permissive);
+    parse_eager("default,none,shift,all", &eager);
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int  rows = 20;
+    int  opt;
+    bool ok = true;
+    while ((opt = getopt(argc, argv, "j:n:t:a:s:p:e:")) != -1) {
+        switch (opt) {
+            case 'j':
+                jobs = strtol(optarg, NULL, 10);
+                break;
+            case 'n':
+                rows = strtol(optarg, NULL, 10);
+                break;
+            case 't':
+                ok = parse_list(optarg, &terms);
+                break;
+            case 'a':
+                ok = parse_list(optarg, &timeouts);
+                break;
+            case 's':
+                ok = parse_list(optarg, &streaks);
+                break;
+            case 'p':
+                ok = parse_list(optarg, &permissive);
+                break;
+            case 'e':
+                ok = parse_eager(optarg, &eager);
+                break;
+            default:
+                ok = false;
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    if (!ok || optind == argc) {
+        fprintf(stderr, "usage: %s [-j jobs] [-n rows] [-t terms] [-a timeouts] [-s streaks] [-p 0,1] [-e default,none,shift,all] traces...\n", argv[0]);
+        return 2;
+    }
+    jobs = jobs < 1 ? 1 : jobs > MAX_JOBS ? MAX_JOBS : jobs;
+
+    const int trace_count = argc - optind;
+    trace_t  *traces      = calloc(trace_count, sizeof(trace_t));
+    for (int i = 0; i < trace_count; i++) {
+        if (!trace_load(argv[optind + i], &traces[i])) {
+            return 1;
+        }
+    }
+
+    // Config 0 is the keymap as built, with the simulator's defaults from
+    // config.h, then the full grid.
+    sim_init();
+    const uint32_t  config_count = 1 + terms.count * timeouts.count * streaks.count * permissive.count * eager.count;
+    sweep_config_t *configs      = malloc(config_count * sizeof(sweep_config_t));
+    configs[0]                   = (sweep_config_t){
+        .keymap          = true,
+        .tapping_term    = sim_config.tapping_term,
+        .streak_timeout  = ACHORDION_DEFAULT_STREAK_TIMEOUT,
+        .permissive_hold = sim_config.permissive_hold,
+        .eager           = EAGER_DEFAULT,
+    };
+    uint32_t n = 1;
+    for (int t = 0; t < terms.count; t++)
+        for (int a = 0; a < timeouts.count; a++)
+            for (int s = 0; s < streaks.count; s++)
+                for (int p = 0; p < permissive.count; p++)
+                    for (int e = 0; e < eager.count; e++) {
+                        configs[n++] = (sweep_config_t){
+                            .tapping_term      = terms.values[t],
+                            .achordion_timeout = timeouts.values[a],
+                            .streak_timeout    = streaks.values[s],
+                            .permissive_hold   = permissive.values[p],
+                            .eager             = eager.values[e],
+                        };
+                    }
+    if (jobs > config_count) {
+        jobs = config_count;
+    }
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    int   pipes[MAX_JOBS];
+    pid_t pids[MAX_JOBS];
+    for (long j = 0; j < jobs; j++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            perror("pipe");
+            return 1;
+        }
+        fflush(stdout);
+        pids[j] = fork();
+        if (pids[j] < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (pids[j] == 0) {
+            close(fds[0]);
+            for (uint32_t i = j; i < config_count; i += jobs) {
+                const sweep_result_t result = run_config(i, &configs[i], traces, trace_count);
+                if (write(fds[1], &result, sizeof(result)) != sizeof(result)) {
+                    _exit(1);
+                }
+            }
+            _exit(0);
+        }
+        close(fds[1]);
+        pipes[j] = fds[0];
+    }
+
+    sweep_result_t *results  = calloc(config_count, sizeof(sweep_result_t));
+    uint32_t        received = 0;
+    for (long j = 0; j < jobs; j++) {
+        sweep_result_t result;
+        while (read(pipes[j], &result, sizeof(result)) == sizeof(result)) {
+            results[result.index] = result;
+            received++;
+        }
+        close(pipes[j]);
+        int status;
+        waitpid(pids[j], &status, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (received != config_count) {
+        fprintf(stderr, "sweep: %u of %u configurations failed\n", config_count - received, config_count);
+        return 1;
+    }
+    const double elapsed = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) * 1e-9;
+
+    printf("%u configurations x %d traces, %u annotated presses, %ld workers, %.2f s\n\n", config_count, trace_count, results[0].scored, jobs, elapsed);
+    printf(" term timeout streak perm eager   t->h h->t misfire    p50   p90   p99   max (ms)\n");
+    print_row(&configs[0], &results[0]);
+    printf("\n");
+    qsort(results + 1, config_count - 1, sizeof(sweep_result_t), compare_results);
+    for (uint32_t i = 1; i < config_count && i <= (uint32_t)rows; i++) {
+        print_row(&configs[results[i].index], &results[i]);
+    }
+    return 0;
+}
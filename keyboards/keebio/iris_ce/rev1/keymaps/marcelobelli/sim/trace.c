@@ -0,0 +1,228 @@
+// Host simulator: key event traces.
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+#define KEY_NAME_SIZE 16
+
+static char key_names[MATRIX_ROWS][MATRIX_COLS][KEY_NAME_SIZE];
+static bool key_names_ready;
+
+const char *trace_keycode_name(uint8_t keycode) {
+    static const char alnum[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890";
+    static char       single[sizeof(alnum)][2];
+    static char       hex[8][5];
+    static uint8_t    hex_next;
+
+    if (keycode >= KC_A && keycode <= KC_0) {
+        char *name = single[keycode - KC_A];
+        name[0]    = alnum[keycode - KC_A];
+        return name;
+    }
+    switch (keycode) {
+        case KC_NO: return "NO";
+        case KC_ENTER: return "ENT";
+        case KC_ESCAPE: return "ESC";
+        case KC_BACKSPACE: return "BSPC";
+        case KC_TAB: return "TAB";
+        case KC_SPACE: return "SPC";
+        case KC_MINUS: return "MINS";
+        case KC_EQUAL: return "EQL";
+        case KC_LEFT_BRACKET: return "LBRC";
+        case KC_RIGHT_BRACKET: return "RBRC";
+        case KC_BACKSLASH: return "BSLS";
+        case KC_SEMICOLON: return "SCLN";
+        case KC_QUOTE: return "QUOT";
+        case KC_GRAVE: return "GRV";
+        case KC_COMMA: return "COMM";
+        case KC_DOT: return "DOT";
+        case KC_SLASH: return "SLSH";
+        case KC_CAPS_LOCK: return "CAPS";
+        case KC_HOME: return "HOME";
+        case KC_PAGE_UP: return "PGUP";
+        case KC_DELETE: return "DEL";
+        case KC_END: return "END";
+        case KC_PAGE_DOWN: return "PGDN";
+        case KC_RIGHT: return "RGHT";
+        case KC_LEFT: return "LEFT";
+        case KC_DOWN: return "DOWN";
+        case KC_UP: return "UP";
+        case KC_KP_SLASH: return "PSLS";
+        case KC_KP_ASTERISK: return "PAST";
+        case KC_KP_MINUS: return "PMNS";
+        case KC_KP_PLUS: return "PPLS";
+        case KC_KP_EQUAL: return "PEQL";
+        case KC_AUDIO_MUTE: return "MUTE";
+        case KC_AUDIO_VOL_UP: return "VOLU";
+        case KC_AUDIO_VOL_DOWN: return "VOLD";
+        case KC_MEDIA_NEXT_TRACK: return "MNXT";
+        case KC_MEDIA_PREV_TRACK: return "MPRV";
+        case KC_MEDIA_STOP: return "MSTP";
+        case KC_MEDIA_PLAY_PAUSE: return "MPLY";
+        case KC_LEFT_CTRL: return "LCTL";
+        case KC_LEFT_SHIFT: return "LSFT";
+        case KC_LEFT_ALT: return "LALT";
+        case KC_LEFT_GUI: return "LGUI";
+        case KC_RIGHT_CTRL: return "RCTL";
+        case KC_RIGHT_SHIFT: return "RSFT";
+        case KC_RIGHT_ALT: return "RALT";
+        case KC_RIGHT_GUI: return "RGUI";
+    }
+    char *name = hex[hex_next++ % 8];
+    snprintf(name, sizeof(hex[0]), "0x%02X", keycode);
+    return name;
+}
+
+// Names every matrix position after its base layer keycode, numbering repeats.
+static void init_key_names(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint16_t keycode = keymap_key_to_keycode(0, (keypos_t){.col = col, .row = row});
+            char    *name    = key_names[row][col];
+            if (IS_QK_MOD_TAP(keycode)) {
+                keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+            } else if (IS_QK_LAYER_TAP(keycode)) {
+                keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+            }
+            if (keycode == KC_NO || keycode > QK_BASIC_MAX) {
+                snprintf(name, KEY_NAME_SIZE, "r%uc%u", row, col);
+                continue;
+            }
+            const char *base    = trace_keycode_name(keycode);
+            uint8_t     repeats = 0;
+            for (uint8_t i = 0; i < row * MATRIX_COLS + col; i++) {
+                const char *other = key_names[i / MATRIX_COLS][i % MATRIX_COLS];
+                const size_t len  = strlen(base);
+                if (strncmp(other, base, len) == 0 && (other[len] == '\0' || other[len] == '#')) {
+                    repeats++;
+                }
+            }
+            if (repeats) {
+                snprintf(name, KEY_NAME_SIZE, "%s#%u", base, repeats);
+            } else {
+                snprintf(name, KEY_NAME_SIZE, "%s", base);
+            }
+        }
+    }
+    key_names_ready = true;
+}
+
+const char *trace_key_name(keypos_t key) {
+    if (!key_names_ready) {
+        init_key_names();
+    }
+    return key_names[key.row][key.col];
+}
+
+bool trace_parse_key(const char *name, keypos_t *key) {
+    unsigned row, col;
+    char     rest;
+    if (sscanf(name, "r%uc%u%c", &row, &col, &rest) == 2) {
+        if (row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+            return false;
+        }
+        *key = (keypos_t){.col = col, .row = row};
+        return true;
+    }
+    // `NAME#0` is the same as `NAME`.
+    char wanted[KEY_NAME_SIZE];
+    snprintf(wanted, sizeof(wanted), "%s", name);
+    const size_t len = strlen(wanted);
+    if (len > 2 && strcmp(wanted + len - 2, "#0") == 0) {
+        wanted[len - 2] = '\0';
+    }
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (strcmp(trace_key_name((keypos_t){.col = col, .row = row}), wanted) == 0) {
+                *key = (keypos_t){.col = col, .row = row};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void trace_append(trace_t *trace, const trace_event_t *event) {
+    if (trace->count == trace->capacity) {
+        trace->capacity = trace->capacity ? trace->capacity * 2 : 256;
+        trace->events   = realloc(trace->events, trace->capacity * sizeof(trace_event_t));
+        if (!trace->events) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    trace->events[trace->count++] = *event;
+}
+
+void trace_free(trace_t *trace) {
+    free(trace->events);
+    *trace = (trace_t){0};
+}
+
+bool trace_load_text(const char *path, trace_t *trace) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    char     line[256];
+    uint32_t line_number = 0;
+    uint32_t last_time   = 0;
+    bool     ok          = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        char *comment = strchr(line, '#');
+        // '#' also appears in key names, so only a leading one starts a comment.
+        if (comment && (comment == line || isspace((unsigned char)comment[-1]))) {
+            *comment = '\0';
+        }
+        unsigned long time;
+        char          action[8], name[KEY_NAME_SIZE], intent[8];
+        int           fields = sscanf(line, "%lu %7s %15s %7s", &time, action, name, intent);
+        if (fields <= 0) {
+            continue; // Blank or comment line.
+        }
+        trace_event_t event = {.time = time, .line = line_number};
+        if (fields == 4 && strcmp(action, "down") == 0) {
+            event.intent = strcmp(intent, "tap") == 0 ? TRACE_INTENT_TAP : strcmp(intent, "hold") == 0 ? TRACE_INTENT_HOLD : TRACE_INTENT_NONE;
+        }
+        if (fields < 3 || (fields == 4 && !event.intent) || (strcmp(action, "down") != 0 && strcmp(action, "up") != 0)) {
+            fprintf(stderr, "%s:%u: expected '<time> down|up <key> [tap|hold]'\n", path, line_number);
+            ok = false;
+        } else if (!trace_parse_key(name, &event.key)) {
+            fprintf(stderr, "%s:%u: unknown key '%s'\n", path, line_number, name);
+            ok = false;
+        } else if (event.time < last_time) {
+            fprintf(stderr, "%s:%u: time goes backwards\n", path, line_number);
+            ok = false;
+        } else {
+            event.pressed = action[0] == 'd';
+            last_time     = event.time;
+            trace_append(trace, &event);
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+void trace_format_report(const sim_report_t *sent, uint32_t start, char *buf, size_t size) {
+    static const char *const mod_names[8] = {"LCTL", "LSFT", "LALT", "LGUI", "RCTL", "RSFT", "RALT", "RGUI"};
+
+    size_t len = snprintf(buf, size, "%6u ", sent->time - start);
+    if (!sent->report.mods) {
+        len += snprintf(buf + len, size - len, " -");
+    }
+    for (uint8_t i = 0; i < 8 && len < size; i++) {
+        if (sent->report.mods & (1 << i)) {
+            len += snprintf(buf + len, size - len, " %s", mod_names[i]);
+        }
+    }
+    len += snprintf(buf + len, size - len, " |");
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS && len < size; i++) {
+        if (sent->report.keys[i]) {
+            len += snprintf(buf + len, size - len, " %s", trace_keycode_name(sent->report.keys[i]));
+        }
+    }
+}
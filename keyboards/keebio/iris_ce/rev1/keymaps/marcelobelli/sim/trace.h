@@ -0,0 +1,64 @@
+// Host simulator: key event traces.
+//
+// A text trace is one event per line, with the time in milliseconds since the
+// start of the session, `down` or `up`, and the key:
+//
+//     # Home row roll.
+//     0    down  F
+//     35   down  J
+//     80   up    F
+//     110  up    J
+//
+// Keys are named by the base layer keycode, with the tap keycode for mod-taps
+// and layer-taps (`F` is LCMD_T(KC_F), `SPC` is LT(_LOWER, KC_SPC)). When a
+// name appears more than once in the matrix, `NAME#n` picks the nth match in
+// row-major order. `rXcY` addresses a matrix position directly.
+//
+// A press of a tap-hold key may be annotated with what the typist meant,
+// `tap` or `hold`, so tools can score the tap-hold decision against it:
+//
+//     0    down  J  hold
+
+#pragma once
+
+#include "sim.h"
+
+typedef struct {
+    uint32_t time; // Milliseconds since the start of the trace.
+    keypos_t key;
+    bool     pressed;
+    uint8_t  intent; // TRACE_INTENT_*, for annotated presses.
+    uint32_t line;   // Source line, for diagnostics.
+} trace_event_t;
+
+enum {
+    TRACE_INTENT_NONE,
+    TRACE_INTENT_TAP,
+    TRACE_INTENT_HOLD,
+};
+
+typedef struct {
+    trace_event_t *events;
+    size_t         count;
+    size_t         capacity;
+} trace_t;
+
+/** Loads a text trace. Prints a diagnostic and returns false on error. */
+bool trace_load_text(const char *path, trace_t *trace);
+
+/** Appends an event, growing the trace as needed. */
+void trace_append(trace_t *trace, const trace_event_t *event);
+
+void trace_free(trace_t *trace);
+
+/** Resolves a key name as described above. */
+bool trace_parse_key(const char *name, keypos_t *key);
+
+/** Returns the trace name of `key`, e.g. "F" or "ENT#1". */
+const char *trace_key_name(keypos_t key);
+
+/** Returns the name of a basic keycode without the KC_ prefix. */
+const char *trace_keycode_name(uint8_t keycode);
+
+/** Formats a report as "<time> <mods> <keys>", time relative to `start`. */
+void trace_format_report(const sim_report_t *sent, uint32_t start, char *buf, size_t size);
@@ -0,0 +1,159 @@
+// Host simulator: binary key event traces (.ktr).
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trace_bin.h"
+
+#define WRITE_BUFFER_SIZE (1 << 20)
+
+bool trace_bin_open(const char *path, trace_bin_t *bin) {
+    *bin         = (trace_bin_t){0};
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return false;
+    }
+    if ((size_t)st.st_size < sizeof(trace_bin_header_t)) {
+        fprintf(stderr, "%s: too short for a .ktr header\n", path);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    const trace_bin_header_t *header = map;
+    if (memcmp(header->magic, TRACE_BIN_MAGIC, 4) != 0 || header->version != TRACE_BIN_VERSION || header->record_size != sizeof(trace_bin_record_t)) {
+        fprintf(stderr, "%s: not a version %d .ktr trace\n", path, TRACE_BIN_VERSION);
+        munmap(map, st.st_size);
+        return false;
+    }
+    if (header->matrix_rows != MATRIX_ROWS || header->matrix_cols != MATRIX_COLS) {
+        fprintf(stderr, "%s: captured on a %ux%u matrix, expected %ux%u\n", path, header->matrix_rows, header->matrix_cols, MATRIX_ROWS, MATRIX_COLS);
+        munmap(map, st.st_size);
+        return false;
+    }
+    bin->header   = header;
+    bin->records  = (const trace_bin_record_t *)(header + 1);
+    bin->count    = (st.st_size - sizeof(trace_bin_header_t)) / sizeof(trace_bin_record_t);
+    bin->map      = map;
+    bin->map_size = st.st_size;
+    return true;
+}
+
+void trace_bin_close(trace_bin_t *bin) {
+    if (bin->map) {
+        munmap(bin->map, bin->map_size);
+    }
+    *bin = (trace_bin_t){0};
+}
+
+void trace_bin_cursor_init(trace_bin_cursor_t *cursor, const trace_bin_t *bin) {
+    *cursor = (trace_bin_cursor_t){.bin = bin};
+}
+
+bool trace_bin_next(trace_bin_cursor_t *cursor, trace_event_t *event, uint16_t *keycode, uint16_t *layers) {
+    while (cursor->index < cursor->bin->count) {
+        const trace_bin_record_t *record = &cursor->bin->records[cursor->index++];
+        cursor->time += record->delta;
+        if (record->flags & TRACE_BIN_GAP) {
+            continue;
+        }
+        *event = (trace_event_t){
+            .time    = cursor->time,
+            .key     = {.col = record->pos & 0xF, .row = record->pos >> 4},
+            .pressed = record->flags & TRACE_BIN_PRESSED,
+            .intent  = (record->flags & TRACE_BIN_TAP) ? TRACE_INTENT_TAP : (record->flags & TRACE_BIN_HOLD) ? TRACE_INTENT_HOLD : TRACE_INTENT_NONE,
+            .line    = cursor->index,
+        };
+        if (keycode) {
+            *keycode = record->keycode;
+        }
+        if (layers) {
+            *layers = record->layer_state;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool trace_load_bin(const char *path, trace_t *trace) {
+    trace_bin_t bin;
+    if (!trace_bin_open(path, &bin)) {
+        return false;
+    }
+    trace_bin_cursor_t cursor;
+    trace_event_t      event;
+    trace_bin_cursor_init(&cursor, &bin);
+    while (trace_bin_next(&cursor, &event, NULL, NULL)) {
+        trace_append(trace, &event);
+    }
+    trace_bin_close(&bin);
+    return true;
+}
+
+bool trace_bin_writer_open(trace_bin_writer_t *writer, const char *path, uint32_t start_time) {
+    *writer = (trace_bin_writer_t){.file = fopen(path, "wb")};
+    if (!writer->file) {
+        perror(path);
+        return false;
+    }
+    setvbuf(writer->file, NULL, _IOFBF, WRITE_BUFFER_SIZE);
+    trace_bin_header_t header = {
+        .magic       = TRACE_BIN_MAGIC,
+        .version     = TRACE_BIN_VERSION,
+        .record_size = sizeof(trace_bin_record_t),
+        .matrix_rows = MATRIX_ROWS,
+        .matrix_cols = MATRIX_COLS,
+        .start_time  = start_time,
+    };
+    return fwrite(&header, sizeof(header), 1, writer->file) == 1;
+}
+
+bool trace_bin_write(trace_bin_writer_t *writer, const trace_event_t *event, uint16_t keycode, uint16_t layers) {
+    uint32_t delta = event->time - writer->last_time;
+    while (delta > UINT16_MAX) {
+        const trace_bin_record_t gap = {.delta = UINT16_MAX, .flags = TRACE_BIN_GAP};
+        if (fwrite(&gap, sizeof(gap), 1, writer->file) != 1) {
+            return false;
+        }
+        delta -= UINT16_MAX;
+    }
+    const trace_bin_record_t record = {
+        .delta       = delta,
+        .keycode     = keycode,
+        .pos         = event->key.row << 4 | event->key.col,
+        .flags       = (event->pressed ? TRACE_BIN_PRESSED : 0) | (event->intent == TRACE_INTENT_TAP ? TRACE_BIN_TAP : 0) | (event->intent == TRACE_INTENT_HOLD ? TRACE_BIN_HOLD : 0),
+        .layer_state = layers,
+    };
+    writer->last_time = event->time;
+    return fwrite(&record, sizeof(record), 1, writer->file) == 1;
+}
+
+bool trace_bin_writer_close(trace_bin_writer_t *writer) {
+    const bool ok = writer->file && fclose(writer->file) == 0;
+    writer->file  = NULL;
+    return ok;
+}
+
+bool trace_load(const char *path, trace_t *trace) {
+    const char *ext = strrchr(path, '.');
+    if (ext && strcmp(ext, ".ktr") == 0) {
+        return trace_load_bin(path, trace);
+    }
+    return trace_load_text(path, trace);
+}
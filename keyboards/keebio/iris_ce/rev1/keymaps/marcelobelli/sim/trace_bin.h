@@ -0,0 +1,97 @@
+// Host simulator: binary key event traces (.ktr).
+//
+// A 16-byte header followed by fixed-width 8-byte records, little endian:
+//
+//     offset  size  field
+//     0       2     delta        ms since the previous record
+//     2       2     keycode      keycode at capture time, informational
+//     4       1     pos          row << 4 | col
+//     5       1     flags        TRACE_BIN_PRESSED, TRACE_BIN_GAP, TRACE_BIN_TAP,
+//                                TRACE_BIN_HOLD
+//     6       2     layer_state  low 16 bits of layer_state at capture time
+//
+// Gaps longer than 65535 ms are split with TRACE_BIN_GAP records, which only
+// advance time. Records need no parsing, so the reader maps the file and
+// walks it in place; captures of any size stream at memory speed.
+
+#pragma once
+
+#include "trace.h"
+
+#define TRACE_BIN_MAGIC "QKTR"
+#define TRACE_BIN_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    char     magic[4];
+    uint8_t  version;
+    uint8_t  record_size;
+    uint8_t  matrix_rows;
+    uint8_t  matrix_cols;
+    uint32_t start_time; // Capture clock at the first record, informational.
+    uint32_t reserved;
+} trace_bin_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t delta;
+    uint16_t keycode;
+    uint8_t  pos;
+    uint8_t  flags;
+    uint16_t layer_state;
+} trace_bin_record_t;
+
+_Static_assert(sizeof(trace_bin_header_t) == 16, "trace_bin_header_t must be 16 bytes");
+_Static_assert(sizeof(trace_bin_record_t) == 8, "trace_bin_record_t must be 8 bytes");
+
+enum {
+    TRACE_BIN_PRESSED = 1 << 0,
+    TRACE_BIN_GAP     = 1 << 1,
+    // Annotated intent of a press, see trace.h.
+    TRACE_BIN_TAP  = 1 << 2,
+    TRACE_BIN_HOLD = 1 << 3,
+};
+
+typedef struct {
+    const trace_bin_header_t *header;
+    const trace_bin_record_t *records;
+    size_t                    count;
+    void                     *map;
+    size_t                    map_size;
+} trace_bin_t;
+
+typedef struct {
+    const trace_bin_t *bin;
+    size_t             index;
+    uint32_t           time;
+} trace_bin_cursor_t;
+
+typedef struct {
+    FILE    *file;
+    uint32_t last_time;
+} trace_bin_writer_t;
+
+/** Maps a .ktr file read-only. Prints a diagnostic and returns false on error. */
+bool trace_bin_open(const char *path, trace_bin_t *bin);
+
+void trace_bin_close(trace_bin_t *bin);
+
+/** Starts a cursor at the first record, with time 0. */
+void trace_bin_cursor_init(trace_bin_cursor_t *cursor, const trace_bin_t *bin);
+
+/**
+ * Reads the next key event. `keycode` and `layers` receive the capture-time
+ * values when non-NULL. Returns false at the end of the trace.
+ */
+bool trace_bin_next(trace_bin_cursor_t *cursor, trace_event_t *event, uint16_t *keycode, uint16_t *layers);
+
+/** Loads a whole .ktr file into `trace`, for the tools that need random access. */
+bool trace_load_bin(const char *path, trace_t *trace);
+
+bool trace_bin_writer_open(trace_bin_writer_t *writer, const char *path, uint32_t start_time);
+
+/** Appends an event. Times must not go backwards. */
+bool trace_bin_write(trace_bin_writer_t *writer, const trace_event_t *event, uint16_t keycode, uint16_t layers);
+
+bool trace_bin_writer_close(trace_bin_writer_t *writer);
+
+/** Loads a .ktr or text trace, by extension. */
+bool trace_load(const char *path, trace_t *trace);
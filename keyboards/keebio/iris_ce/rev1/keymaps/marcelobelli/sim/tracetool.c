@@ -0,0 +1,415 @@
+// Host simulator: .ktr trace tool.
+//
+//     ./build/tracetool pack in.trace out.ktr   Convert a text trace.
+//     ./build/tracetool unpack in.ktr           Print a .ktr as a text trace.
+//     ./build/tracetool play [-r] [-s] in.ktr...
+//                                               Stream into the simulator.
+//     ./build/tracetool import dump.txt [out.ktr]
+//                                               Decode a Key Recorder dump.
+//     ./build/tracetool stats dump.txt          Decode a Tap-Hold Stats dump.
+//     ./build/tracetool log dump.txt            Decode Token Log records.
+//
+// `pack` replays the trace through the simulator to record the keycode and
+// layer state each event had. `play` walks the mapped file record by record
+// and never materializes the trace, so its memory use is independent of the
+// capture size. -r disables the RGB Matrix task, -s prints a Tap-Hold Stats
+// dump at the end. `import` reads a console log containing a RECDUMP (see
+// features/key_recorder.h), prints the key events and Achordion settle
+// decisions, and writes the key events as a .ktr. `stats` reads a console log
+// (or `-` for stdin) containing a STATDMP (see features/tap_hold_stats.h) and
+// prints each key's settle latency histograms; with several dumps in the log,
+// the last one. `log` prints the messages in a console log (or `-`) of Token
+// Log records (see features/token_log.h), formatted from the same message
+// list the firmware was built with.
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "features/key_recorder.h"
+#include "features/tap_hold_stats.h"
+#include "features/token_log.h"
+#include "trace_bin.h"
+
+static int pack(const char *in, const char *out) {
+    trace_t trace = {0};
+    if (!trace_load_text(in, &trace)) {
+        return 1;
+    }
+    trace_bin_writer_t writer;
+    if (!trace_bin_writer_open(&writer, out, 0)) {
+        return 1;
+    }
+    sim_init();
+    bool ok = true;
+    for (size_t i = 0; ok && i < trace.count; i++) {
+        const trace_event_t *event = &trace.events[i];
+        sim_advance_to(event->time);
+        const keyevent_t keyevent = {.key = event->key, .pressed = event->pressed, .type = KEY_EVENT};
+        ok                        = trace_bin_write(&writer, event, get_event_keycode(keyevent, false), layer_state);
+        sim_key(event->key, event->pressed);
+    }
+    if (!trace_bin_writer_close(&writer) || !ok) {
+        perror(out);
+        return 1;
+    }
+    printf("%s: %zu events\n", out, trace.count);
+    trace_free(&trace);
+    return 0;
+}
+
+static int unpack(const char *in) {
+    trace_bin_t bin;
+    if (!trace_bin_open(in, &bin)) {
+        return 1;
+    }
+    trace_bin_cursor_t cursor;
+    trace_event_t      event;
+    uint16_t           keycode, layers;
+    trace_bin_cursor_init(&cursor, &bin);
+    printf("# Unpacked from %s.\n", in);
+    while (trace_bin_next(&cursor, &event, &keycode, &layers)) {
+        static const char *const intents[] = {"", "tap", "hold"};
+        printf("%-8u %-4s  %-8s %-4s  # keycode 0x%04X layers 0x%04X\n", event.time, event.pressed ? "down" : "up", trace_key_name(event.key), intents[event.intent], keycode, layers);
+    }
+    trace_bin_close(&bin);
+    return 0;
+}
+
+static int play(int argc, char **argv) {
+    bool rgb   = true;
+    bool stats = false;
+    int  opt;
+    while ((opt = getopt(argc, argv, "rs")) != -1) {
+        switch (opt) {
+            case 'r':
+                rgb = false;
+                break;
+            case 's':
+                stats = true;
+                break;
+            default:
+                return 2;
+        }
+    }
+    sim_init();
+    sim_config.rgb_enabled = rgb;
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (int i = optind; i < argc; i++) {
+        trace_bin_t bin;
+        if (!trace_bin_open(argv[i], &bin)) {
+            return 1;
+        }
+        trace_bin_cursor_t cursor;
+        trace_event_t      event;
+        const uint32_t     start = sim_now();
+        trace_bin_cursor_init(&cursor, &bin);
+        while (trace_bin_next(&cursor, &event, NULL, NULL)) {
+            sim_advance_to(start + event.time);
+            sim_key(event.key, event.pressed);
+        }
+        trace_bin_close(&bin);
+        sim_quiesce(2000);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    const double elapsed = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) * 1e-9;
+
+    printf("key events:     %u\n", sim_stats.key_events);
+    printf("virtual time:   %.1f s\n", sim_now() / 1000.0);
+    printf("reports:        %u sent / %u requested\n", sim_stats.reports_sent, sim_stats.reports_requested);
+    printf("host time:      %.3f s\n", elapsed);
+    printf("events/sec:     %.0f\n", sim_stats.key_events / elapsed);
+    if (stats) {
+        tap_hold_stats_dump();
+    }
+    return 0;
+}
+
+static const char *const settle_names[] = {
+    [KEY_RECORD_SETTLE_TAP]     = "tap",
+    [KEY_RECORD_SETTLE_HOLD]    = "hold",
+    [KEY_RECORD_SETTLE_TIMEOUT] = "timeout",
+    [KEY_RECORD_SETTLE_STREAK]  = "streak",
+};
+
+static int import(const char *in, const char *out) {
+    FILE *file = fopen(in, "r");
+    if (!file) {
+        perror(in);
+        return 1;
+    }
+    trace_bin_writer_t writer;
+    if (out && !trace_bin_writer_open(&writer, out, 0)) {
+        fclose(file);
+        return 1;
+    }
+
+    // Record times are the low 16 bits of the firmware timer. Unwrap them on
+    // the assumption that consecutive records are less than 32 s apart; key
+    // events carry `timer_read() | 1`, so a settle record right after one can
+    // be a millisecond behind it.
+    char     line[512];
+    bool     started = false;
+    uint16_t last    = 0;
+    uint32_t time    = 0;
+    size_t   count   = 0;
+    bool     ok      = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        const char *p = strstr(line, "key_recorder:");
+        if (!p) {
+            continue;
+        }
+        p += strlen("key_recorder:");
+        unsigned value;
+        int      n;
+        while (sscanf(p, " %8x%n", &value, &n) == 1 && n > 8) {
+            p += n;
+            const key_record_t record = {.time = value >> 16, .pos = value >> 8, .flags = value};
+            const keypos_t     key    = {.col = record.pos & 0xF, .row = record.pos >> 4};
+            const int16_t delta = record.time - last;
+            if (started && delta > 0) {
+                time += delta;
+            }
+            started           = true;
+            last              = record.time;
+            const uint8_t kind = KEY_RECORD_KIND(record);
+            if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS || kind > KEY_RECORD_SETTLE_STREAK) {
+                fprintf(stderr, "%s: bad record %08X\n", in, value);
+                ok = false;
+                break;
+            }
+            if (kind == KEY_RECORD_DOWN || kind == KEY_RECORD_UP) {
+                const trace_event_t event = {.time = time, .key = key, .pressed = kind == KEY_RECORD_DOWN};
+                printf("%-8u %-4s  %-8s  # layer %u\n", time, event.pressed ? "down" : "up", trace_key_name(key), KEY_RECORD_LAYER(record));
+                if (out) {
+                    ok = trace_bin_write(&writer, &event, keymap_key_to_keycode(KEY_RECORD_LAYER(record), key), 1 << KEY_RECORD_LAYER(record));
+                }
+                count++;
+            } else {
+                printf("# %-6u settle %-7s %s\n", time, settle_names[kind], trace_key_name(key));
+            }
+        }
+    }
+    fclose(file);
+    if (out && (!trace_bin_writer_close(&writer) || !ok)) {
+        perror(out);
+        return 1;
+    }
+    if (!started) {
+        fprintf(stderr, "%s: no key_recorder records\n", in);
+        return 1;
+    }
+    fprintf(stderr, "%s: %zu key events\n", in, count);
+    return ok ? 0 : 1;
+}
+
+static const char *const outcome_names[TAP_HOLD_OUTCOME_COUNT] = {
+    [TAP_HOLD_CHORD_HOLD]   = "chord hold",
+    [TAP_HOLD_TIMEOUT_HOLD] = "timeout hold",
+    [TAP_HOLD_RELEASE_HOLD] = "release hold",
+    [TAP_HOLD_TAP]          = "tap",
+    [TAP_HOLD_STREAK_TAP]   = "streak tap",
+    [TAP_HOLD_QMK_TAP]      = "qmk tap",
+    [TAP_HOLD_QMK_HOLD]     = "qmk hold",
+};
+
+// Lowest latency in `bucket`, in ms.
+static unsigned bucket_floor(uint8_t bucket) {
+    return bucket ? 1u << bucket : 0;
+}
+
+// Bucket holding the `percent`th percentile of `total` counts.
+static uint8_t percentile_bucket(const uint16_t *counts, uint32_t total, uint8_t percent) {
+    const uint32_t rank = (total * percent + 99) / 100;
+    uint32_t       seen = 0;
+    for (uint8_t b = 0; b < TAP_HOLD_STATS_BUCKETS; b++) {
+        seen += counts[b];
+        if (seen >= rank) {
+            return b;
+        }
+    }
+    return TAP_HOLD_STATS_BUCKETS - 1;
+}
+
+static void print_bucket_range(uint8_t bucket) {
+    char range[24];
+    if (bucket == TAP_HOLD_STATS_BUCKETS - 1) {
+        snprintf(range, sizeof(range), "%u+", bucket_floor(bucket));
+    } else {
+        snprintf(range, sizeof(range), "%u-%u", bucket_floor(bucket), bucket_floor(bucket + 1) - 1);
+    }
+    printf(" %10s", range);
+}
+
+static int stats(const char *in) {
+    FILE *file = strcmp(in, "-") ? fopen(in, "r") : stdin;
+    if (!file) {
+        perror(in);
+        return 1;
+    }
+    // Rows of the last dump in the log.
+    static struct {
+        uint8_t  pos;
+        uint8_t  outcome;
+        uint16_t counts[TAP_HOLD_STATS_BUCKETS];
+    } rows[TAP_HOLD_STATS_MAX_KEYS * TAP_HOLD_OUTCOME_COUNT];
+    size_t   row_count = 0;
+    unsigned dropped   = 0;
+    bool     complete  = false;
+    bool     ok        = true;
+    char     line[512];
+    while (ok && fgets(line, sizeof(line), file)) {
+        const char *p = strstr(line, "tap_hold_stats:");
+        if (!p) {
+            continue;
+        }
+        p += strlen("tap_hold_stats:");
+        unsigned keys, pos, outcome;
+        int      n;
+        if (sscanf(p, " begin %u %u", &keys, &dropped) == 2) {
+            row_count = 0;
+            complete  = false;
+            continue;
+        }
+        if (strncmp(p, " end", 4) == 0) {
+            complete = true;
+            continue;
+        }
+        if (sscanf(p, " %2x %1x%n", &pos, &outcome, &n) != 2 || outcome >= TAP_HOLD_OUTCOME_COUNT || (pos >> 4) >= MATRIX_ROWS || (pos & 0xF) >= MATRIX_COLS || row_count == sizeof(rows) / sizeof(rows[0])) {
+            fprintf(stderr, "%s: bad line: %s", in, line);
+            ok = false;
+            break;
+        }
+        rows[row_count].pos     = pos;
+        rows[row_count].outcome = outcome;
+        p += n;
+        for (uint8_t b = 0; b < TAP_HOLD_STATS_BUCKETS; b++) {
+            unsigned count;
+            if (sscanf(p, " %4x%n", &count, &n) != 1) {
+                fprintf(stderr, "%s: short line: %s", in, line);
+                ok = false;
+                break;
+            }
+            rows[row_count].counts[b] = count;
+            p += n;
+        }
+        row_count++;
+    }
+    if (file != stdin) {
+        fclose(file);
+    }
+    if (!ok) {
+        return 1;
+    }
+    if (!complete) {
+        fprintf(stderr, "%s: no complete tap_hold_stats dump\n", in);
+        return 1;
+    }
+
+    printf("%-8s %-12s %7s %10s %10s %10s  (ms)\n", "key", "outcome", "count", "p50", "p90", "max");
+    for (size_t i = 0; i < row_count; i++) {
+        const uint16_t *counts = rows[i].counts;
+        uint32_t        total  = 0;
+        uint8_t         max    = 0;
+        for (uint8_t b = 0; b < TAP_HOLD_STATS_BUCKETS; b++) {
+            total += counts[b];
+            if (counts[b]) {
+                max = b;
+            }
+        }
+        const keypos_t key = {.col = rows[i].pos & 0xF, .row = rows[i].pos >> 4};
+        printf("%-8s %-12s %7u", trace_key_name(key), outcome_names[rows[i].outcome], total);
+        print_bucket_range(percentile_bucket(counts, total, 50));
+        print_bucket_range(percentile_bucket(counts, total, 90));
+        print_bucket_range(max);
+        printf("\n");
+    }
+    printf("\n%-21s", "bucket floor (ms)");
+    for (uint8_t b = 0; b < TAP_HOLD_STATS_BUCKETS; b++) {
+        printf(" %5u", bucket_floor(b));
+    }
+    printf("\n");
+    for (size_t i = 0; i < row_count; i++) {
+        const keypos_t key = {.col = rows[i].pos & 0xF, .row = rows[i].pos >> 4};
+        printf("%-8s %-12s", trace_key_name(key), outcome_names[rows[i].outcome]);
+        for (uint8_t b = 0; b < TAP_HOLD_STATS_BUCKETS; b++) {
+            printf(" %5u", rows[i].counts[b]);
+        }
+        printf("\n");
+    }
+    if (dropped) {
+        printf("\n%u settles of keys without a slot (TAP_HOLD_STATS_MAX_KEYS)\n", dropped);
+    }
+    return 0;
+}
+
+static const char *const log_formats[TOKEN_LOG_MESSAGE_COUNT] = {TOKEN_LOG_MESSAGES(TOKEN_LOG_FORMAT)};
+
+static int decode_log(const char *in) {
+    FILE *file = strcmp(in, "-") ? fopen(in, "r") : stdin;
+    if (!file) {
+        perror(in);
+        return 1;
+    }
+    // Unwrapped as in import(): records are less than 32 s apart.
+    char     line[512];
+    bool     started = false;
+    uint16_t last    = 0;
+    uint32_t time    = 0;
+    size_t   count   = 0;
+    while (fgets(line, sizeof(line), file)) {
+        const char *p = strstr(line, "token_log:");
+        unsigned    time16, id, arg;
+        if (!p || sscanf(p + strlen("token_log:"), " %4x%2x%4x", &time16, &id, &arg) != 3) {
+            continue;
+        }
+        const int16_t delta = time16 - last;
+        if (started && delta > 0) {
+            time += delta;
+        }
+        started = true;
+        last    = time16;
+        printf("%-8u ", time);
+        if (id < TOKEN_LOG_MESSAGE_COUNT) {
+            printf(log_formats[id], arg);
+        } else {
+            printf("unknown message 0x%02X (0x%04X), firmware newer than tracetool?", id, arg);
+        }
+        printf("\n");
+        count++;
+    }
+    if (file != stdin) {
+        fclose(file);
+    }
+    if (!started) {
+        fprintf(stderr, "%s: no token_log records\n", in);
+        return 1;
+    }
+    fprintf(stderr, "%s: %zu messages\n", in, count);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "pack") == 0) {
+        return pack(argv[2], argv[3]);
+    }
+    if (argc == 3 && strcmp(argv[1], "unpack") == 0) {
+        return unpack(argv[2]);
+    }
+    if (argc >= 3 && strcmp(argv[1], "play") == 0) {
+        return play(argc - 1, argv + 1);
+    }
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "import") == 0) {
+        return import(argv[2], argc == 4 ? argv[3] : NULL);
+    }
+    if (argc == 3 && strcmp(argv[1], "stats") == 0) {
+        return stats(argv[2]);
+    }
+    if (argc == 3 && strcmp(argv[1], "log") == 0) {
+        return decode_log(argv[2]);
+    }
+    fprintf(stderr, "usage: %s pack in.trace out.ktr | unpack in.ktr | play [-r] [-s] in.ktr... | import dump.txt [out.ktr] | stats dump.txt | log dump.txt\n", argv[0]);
+    return 2;
+}